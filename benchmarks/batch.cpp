@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "KUKA.hpp"
+
+#include "kc/BatchCostFunction.hpp"
+#include "kc/CostFunction.hpp"
+#include "kc/Robot.hpp"
+#include "kc/io.hpp"
+#include "kc/types.hpp"
+
+#include "ceres/ceres.h"
+
+using KUKA  = kc::Robot<kc::LR, kc::LR, kc::LR, kc::LR, kc::LR, kc::LR, kc::LR>;
+using Clock = std::chrono::steady_clock;
+
+// Builds and solves the KUKA training problem with residual blocks of B samples (B = 1 is the
+// per-sample kc::CostFunction layout) and prints construction and solve times.
+template<std::size_t B>
+void run(const kc::Columns<KUKA::N> &joint_angles, const kc::Columns<3> &xyz, const std::size_t training_set)
+{
+  // clang-format off
+  double         a[]     = {      0,      0,      0,      0,      0,      0,     0 };
+  double         alpha[] = { M_PI_2, M_PI_2, M_PI_2, M_PI_2, M_PI_2, M_PI_2,     0 };
+  double         d[]     = {   0.34,      0,    0.4,      0,    0.4,      0, 0.126 };
+  double         theta[] = {   M_PI,   M_PI,      0,   M_PI,      0,   M_PI,     0 };
+  // clang-format on
+
+  const auto     start = Clock::now();
+  ceres::Problem problem;
+  if constexpr (B == 1)
+    for (std::size_t i{}; i < training_set; ++i)
+      problem.AddResidualBlock(kc::CostFunction<KUKA>::create(joint_angles.row(i), xyz.row(i)), nullptr, a, alpha, d, theta);
+  else
+    kc::add_batched_residuals<KUKA, B>(problem, joint_angles, xyz, 0, training_set, a, alpha, d, theta);
+
+  for (std::size_t i{}; i < KUKA::N; ++i)
+  {
+    problem.SetParameterLowerBound(a, i, 0.);
+    problem.SetParameterLowerBound(alpha, i, 0.);
+    problem.SetParameterLowerBound(d, i, 0.);
+    problem.SetParameterLowerBound(theta, i, 0.);
+    problem.SetParameterUpperBound(alpha, i, 2.0 * ceres::constants::pi);
+    problem.SetParameterUpperBound(theta, i, 2.0 * ceres::constants::pi);
+  }
+  const std::chrono::duration<double> construction = Clock::now() - start;
+
+  ceres::Solver::Options options;
+  options.max_num_iterations = 10;
+
+  ceres::Solver::Summary summary;
+  ceres::Solve(options, &problem, &summary);
+
+  const int iterations = summary.num_successful_steps + summary.num_unsuccessful_steps;
+  std::cout << std::right << std::setw(6) << B
+            << std::right << std::setw(9) << problem.NumResidualBlocks()
+            << std::right << std::fixed << std::setprecision(4) << std::setw(15) << construction.count()
+            << std::right << std::fixed << std::setprecision(4) << std::setw(12) << summary.total_time_in_seconds
+            << std::right << std::fixed << std::setprecision(4) << std::setw(15) << summary.total_time_in_seconds / std::max(iterations, 1)
+            << std::right << std::scientific << std::setprecision(6) << std::setw(16) << summary.final_cost << "\n";
+}
+
+int main(void)
+{
+  kc::Columns<3>       xyz;
+  kc::Columns<KUKA::N> joint_angles;
+  if (const auto status = kc::load_samples(Q_KUKA, P_KUKA, joint_angles, xyz); !status)
+  {
+    std::cerr << status.message << "\n";
+    return EXIT_FAILURE;
+  }
+  const std::size_t training_set = std::size_t((double)xyz.rows() * 0.8);
+
+  std::cout << std::right << std::setw(6) << "batch"
+            << std::right << std::setw(9) << "blocks"
+            << std::right << std::setw(15) << "construct [s]"
+            << std::right << std::setw(12) << "solve [s]"
+            << std::right << std::setw(15) << "s / iteration"
+            << std::right << std::setw(16) << "final cost"
+            << "\n";
+  run<1>(joint_angles, xyz, training_set);
+  run<16>(joint_angles, xyz, training_set);
+  run<64>(joint_angles, xyz, training_set);
+  run<256>(joint_angles, xyz, training_set);
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "kc/DynamicRobot.hpp"
+#include "kc/Robot.hpp"
+#include "kc/io.hpp"
+
+#include "synthetic.hpp"
+
+using KUKA  = synthetic::KUKA;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t samples = 1 << 16;
+
+struct Timing
+{
+  double fk_jacobian{}, fk_batch{}; // million samples per second
+  double max_error{};               // largest deviation from Robot<Links...>
+};
+
+void print(const std::string &name, const Timing &timing)
+{
+  std::cout << std::left << std::setw(22) << name
+            << std::right << std::fixed << std::setprecision(2) << std::setw(18) << timing.fk_jacobian
+            << std::right << std::fixed << std::setprecision(2) << std::setw(16) << timing.fk_batch
+            << std::right << std::scientific << std::setprecision(2) << std::setw(14) << timing.max_error << "\n";
+}
+
+// Compares the throughput of fk_jacobian and fk_batch of the static KUKA instantiation against
+// kc::DynamicRobot built from the same joint sequence, once routed to the static kernels and once
+// forced through the generic per-link loop.
+int main(void)
+{
+  const synthetic::Parameters truth;
+  const double *const         a = truth.a, *const alpha = truth.alpha, *const d = truth.d, *const theta = truth.theta;
+
+  kc::Columns<synthetic::N> joint_angles;
+  kc::Columns<3>            xyz;
+  synthetic::generate(truth, samples, joint_angles, xyz);
+
+  std::vector<double> reference(3 * samples), positions(3 * samples);
+  double              sink{};
+
+  Timing     fixed;
+  const auto start = Clock::now();
+  for (std::size_t i{}; i < samples; ++i)
+  {
+    KUKA::JacobianMatrix jacobian;
+    sink += KUKA::fk_jacobian(a, alpha, d, theta, joint_angles.row(i), jacobian).x() + jacobian(0, 0);
+  }
+  fixed.fk_jacobian     = double(samples) / std::chrono::duration<double>(Clock::now() - start).count() * 1e-6;
+  const auto batch_time = Clock::now();
+  KUKA::fk_batch(a, alpha, d, theta, joint_angles.data(), samples, reference.data());
+  fixed.fk_batch = double(samples) / std::chrono::duration<double>(Clock::now() - batch_time).count() * 1e-6;
+
+  std::cout << samples << " synthetic KUKA samples, " << KUKA::shape() << "\n";
+  std::cout << std::left << std::setw(22) << "model"
+            << std::right << std::setw(18) << "fk_jacobian [M/s]"
+            << std::right << std::setw(16) << "fk_batch [M/s]"
+            << std::right << std::setw(14) << "max error" << "\n";
+  print("Robot<Links...>", fixed);
+
+  std::vector<kc::LinkType> links;
+  (void)kc::parse_links(KUKA::shape(), links);
+  for (const bool dispatch : {true, false})
+  {
+    const kc::DynamicRobot         robot(links, dispatch);
+    kc::DynamicRobot::Workspace    workspace = robot.workspace();
+    kc::DynamicRobot::JacobianMatrix jacobian(3, 4 * robot.size());
+    KUKA::JacobianMatrix           expected;
+
+    Timing     timing;
+    const auto jacobian_start = Clock::now();
+    for (std::size_t i{}; i < samples; ++i)
+      sink += robot.fk_jacobian(a, alpha, d, theta, joint_angles.row(i), jacobian, workspace).x() + jacobian(0, 0);
+    timing.fk_jacobian = double(samples) / std::chrono::duration<double>(Clock::now() - jacobian_start).count() * 1e-6;
+
+    const auto dynamic_batch = Clock::now();
+    robot.fk_batch(a, alpha, d, theta, joint_angles.data(), samples, samples, positions.data(), samples, workspace);
+    timing.fk_batch = double(samples) / std::chrono::duration<double>(Clock::now() - dynamic_batch).count() * 1e-6;
+
+    for (std::size_t i{}; i < 3 * samples; ++i)
+      timing.max_error = std::max(timing.max_error, std::abs(positions[i] - reference[i]));
+    for (std::size_t i{}; i < samples; i += 97)
+    {
+      KUKA::fk_jacobian(a, alpha, d, theta, joint_angles.row(i), expected);
+      robot.fk_jacobian(a, alpha, d, theta, joint_angles.row(i), jacobian, workspace);
+      timing.max_error = std::max(timing.max_error, (jacobian - expected).cwiseAbs().maxCoeff());
+    }
+    print(dispatch ? "DynamicRobot (static)" : "DynamicRobot (generic)", timing);
+  }
+
+  return sink != 0. ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "kc/Robot.hpp"
+#include "kc/types.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+// Times count evaluations of Robot::fk against one call to Robot::fk_batch on random joint
+// configurations and reports throughput, speedup and the largest deviation between the two.
+template<class Robot>
+void run(const char *const name, const std::size_t count)
+{
+  constexpr std::size_t N = Robot::N;
+
+  std::mt19937                           generator{42};
+  std::uniform_real_distribution<double> angle{-M_PI, M_PI};
+  std::uniform_real_distribution<double> length{0., 0.5};
+
+  double a[N], alpha[N], d[N], theta[N];
+  for (std::size_t i{}; i < N; ++i)
+  {
+    a[i]     = length(generator);
+    alpha[i] = angle(generator);
+    d[i]     = length(generator);
+    theta[i] = angle(generator);
+  }
+
+  std::vector<double> q_soa(N * count), scalar(3 * count), batch(3 * count);
+  for (auto &q : q_soa)
+    q = angle(generator);
+
+  const auto                  scalar_start = Clock::now();
+  typename Robot::JointAngles q;
+  for (std::size_t sample{}; sample < count; ++sample)
+  {
+    for (std::size_t joint{}; joint < N; ++joint)
+      q[joint] = q_soa[joint * count + sample];
+    const kc::PositionVector xyz = Robot::fk(a, alpha, d, theta, q);
+    for (std::size_t row{}; row < 3; ++row)
+      scalar[row * count + sample] = xyz[row];
+  }
+  const std::chrono::duration<double> scalar_time = Clock::now() - scalar_start;
+
+  const auto batch_start = Clock::now();
+  Robot::fk_batch(a, alpha, d, theta, q_soa.data(), count, batch.data());
+  const std::chrono::duration<double> batch_time = Clock::now() - batch_start;
+
+  double max_error{};
+  for (std::size_t i{}; i < scalar.size(); ++i)
+    max_error = std::max(max_error, std::abs(scalar[i] - batch[i]));
+
+  std::cout << std::left << std::setw(10) << name
+            << std::right << std::fixed << std::setprecision(2) << std::setw(16) << double(count) / scalar_time.count() * 1e-6
+            << std::right << std::fixed << std::setprecision(2) << std::setw(16) << double(count) / batch_time.count() * 1e-6
+            << std::right << std::fixed << std::setprecision(2) << std::setw(10) << scalar_time.count() / batch_time.count()
+            << std::right << std::scientific << std::setprecision(3) << std::setw(14) << max_error << "\n";
+}
+
+int main(void)
+{
+  constexpr std::size_t count = 1 << 20;
+
+  std::cout << "lanes: " << kc::simd::width << ", configurations: " << count << "\n";
+  std::cout << std::left << std::setw(10) << "robot"
+            << std::right << std::setw(16) << "fk [Mpose/s]"
+            << std::right << std::setw(16) << "batch [Mpose/s]"
+            << std::right << std::setw(10) << "speedup"
+            << std::right << std::setw(14) << "max |error|"
+            << "\n";
+  run<kc::Robot<kc::LR, kc::LR, kc::LR>>("3R", count);
+  run<kc::Robot<kc::LR, kc::LR, kc::LP, kc::LR, kc::LR, kc::LR>>("Stanford", count);
+  run<kc::Robot<kc::LR, kc::LR, kc::LR, kc::LR, kc::LR, kc::LR, kc::LR>>("KUKA", count);
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "kc/InverseKinematics.hpp"
+#include "kc/io.hpp"
+
+#include "synthetic.hpp"
+
+using KUKA  = synthetic::KUKA;
+using Clock = std::chrono::steady_clock;
+
+using synthetic::N;
+using synthetic::nominal_a;
+using synthetic::nominal_alpha;
+using synthetic::nominal_d;
+using synthetic::nominal_theta;
+
+constexpr std::size_t waypoints = 200000;
+
+int main(void)
+{
+  // Joint angles commanded by a controller that only knows the nominal model, compensated for the
+  // "true" (calibrated) parameters of the simulated arm
+  const synthetic::Parameters truth;
+
+  kc::Columns<N>                         commanded;
+  std::mt19937                           generator{42};
+  std::uniform_real_distribution<double> angle{-M_PI, M_PI};
+  commanded.resize(waypoints);
+  std::generate_n(commanded.data(), N * waypoints, [&] { return angle(generator); });
+
+  kc::Columns<3> nominal, reached;
+  nominal.resize(waypoints);
+  reached.resize(waypoints);
+  KUKA::fk_batch(nominal_a, nominal_alpha, nominal_d, nominal_theta, commanded.data(), waypoints, nominal.data());
+  KUKA::fk_batch(truth.a, truth.alpha, truth.d, truth.theta, commanded.data(), waypoints, reached.data());
+  double uncompensated{};
+  for (std::size_t i{}; i < waypoints; ++i)
+    uncompensated = std::max(uncompensated, (nominal.row(i) - reached.row(i)).norm());
+
+  const std::size_t        max_threads = std::max(1U, std::thread::hardware_concurrency());
+  std::vector<std::size_t> thread_counts;
+  for (std::size_t threads{1}; threads < max_threads; threads *= 2)
+    thread_counts.push_back(threads);
+  thread_counts.push_back(max_threads);
+
+  std::cout << "KUKA compensation of " << waypoints << " commanded waypoints, max error before "
+            << std::fixed << std::setprecision(3) << uncompensated * 1e3 << " mm\n";
+  std::cout << std::right << std::setw(8) << "threads"
+            << std::right << std::setw(14) << "waypoints/s"
+            << std::right << std::setw(12) << "converged"
+            << std::right << std::setw(12) << "mean iter"
+            << std::right << std::setw(10) << "max iter"
+            << std::right << std::setw(16) << "max error [m]"
+            << "\n";
+
+  kc::Columns<N>      compensated;
+  std::vector<double> errors(waypoints);
+  for (const std::size_t threads : thread_counts)
+  {
+    kc::IKOptions options;
+    options.num_threads = threads;
+    const kc::InverseKinematics<KUKA> ik(truth.a, truth.alpha, truth.d, truth.theta, options);
+    const kc::IKSummary               summary = ik.compensate(nominal_a, nominal_alpha, nominal_d, nominal_theta, commanded, compensated, errors.data());
+    std::cout << std::right << std::setw(8) << threads
+              << std::right << std::fixed << std::setprecision(0) << std::setw(14) << double(waypoints) / summary.time_in_seconds
+              << std::right << std::setw(12) << summary.converged
+              << std::right << std::fixed << std::setprecision(2) << std::setw(12) << summary.mean_iterations
+              << std::right << std::setw(10) << summary.max_iterations
+              << std::right << std::scientific << std::setprecision(2) << std::setw(16) << summary.max_error << "\n";
+  }
+
+  // The compensated angles must bring the true arm onto the nominal targets, up to the errors
+  // reported for the targets not reached (near-singular, stretched poses)
+  KUKA::fk_batch(truth.a, truth.alpha, truth.d, truth.theta, compensated.data(), waypoints, reached.data());
+  double      mismatch{};
+  std::size_t unreached{};
+  for (std::size_t i{}; i < waypoints; ++i)
+  {
+    mismatch = std::max(mismatch, std::abs((nominal.row(i) - reached.row(i)).norm() - errors[i]));
+    unreached += errors[i] > kc::IKOptions{}.tolerance ? 1 : 0;
+  }
+  std::cout << "not reached: " << unreached << ", reported vs fk_batch error mismatch: "
+            << std::scientific << std::setprecision(2) << mismatch << " m\n";
+
+  // Latency of single targets on one thread
+  const std::size_t                 probes = 20000;
+  const kc::InverseKinematics<KUKA> ik(truth.a, truth.alpha, truth.d, truth.theta);
+  std::vector<double>               latency(probes);
+  for (std::size_t i{}; i < probes; ++i)
+  {
+    const auto start = Clock::now();
+    (void)ik.solve(nominal.row(i), commanded.row(i));
+    latency[i] = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+  }
+  std::sort(latency.begin(), latency.end());
+  std::cout << "single-target latency [us]: p50 " << std::fixed << std::setprecision(2) << latency[probes / 2]
+            << ", p99 " << latency[probes * 99 / 100] << ", max " << latency.back() << "\n";
+  return mismatch < 1e-9 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "kc/IncrementalCalibrator.hpp"
+#include "kc/Robot.hpp"
+#include "kc/io.hpp"
+
+#include "synthetic.hpp"
+
+using KUKA  = synthetic::KUKA;
+using Clock = std::chrono::steady_clock;
+
+using synthetic::N;
+
+constexpr std::size_t batch      = 1000;
+constexpr std::size_t batches    = 60;
+constexpr std::size_t validation = 10000;
+
+auto rmse(const kc::IncrementalCalibrator<KUKA> &calibrator, const kc::Columns<N> &joint_angles, const kc::Columns<3> &xyz) -> double
+{
+  std::vector<double> predicted(3 * xyz.rows());
+  KUKA::fk_batch(calibrator.a(), calibrator.alpha(), calibrator.d(), calibrator.theta(), joint_angles.data(), xyz.rows(), predicted.data());
+  double sum{};
+  for (std::size_t i{}; i < predicted.size(); ++i)
+    sum += (predicted[i] - xyz.data()[i]) * (predicted[i] - xyz.data()[i]);
+  return std::sqrt(sum / double(xyz.rows()));
+}
+
+// Streams batches of synthetic KUKA samples into an IncrementalCalibrator started from the
+// nominal DH parameters and reports the cost of folding each batch in, of refreshing the
+// parameters and the validation RMSE reached so far.
+int main(void)
+{
+  const synthetic::Parameters truth;
+
+  kc::Columns<N> stream_q, validation_q;
+  kc::Columns<3> stream_xyz, validation_xyz;
+  synthetic::generate(truth, batch * batches, stream_q, stream_xyz, 42);
+  synthetic::generate(truth, validation, validation_q, validation_xyz, 43);
+
+  kc::IncrementalCalibrator<KUKA> calibrator(synthetic::nominal_a, synthetic::nominal_alpha, synthetic::nominal_d, synthetic::nominal_theta);
+
+  std::cout << "batches of " << batch << " samples, " << validation << " validation samples\n";
+  std::cout << std::right << std::setw(9) << "samples"
+            << std::right << std::setw(12) << "add [ms]"
+            << std::right << std::setw(13) << "update [ms]"
+            << std::right << std::setw(12) << "|step|"
+            << std::right << std::setw(14) << "rmse [mm]"
+            << "\n";
+  std::cout << std::right << std::setw(9) << 0 << std::setw(12) << "-" << std::setw(13) << "-" << std::setw(12) << "-"
+            << std::right << std::fixed << std::setprecision(4) << std::setw(14) << rmse(calibrator, validation_q, validation_xyz) * 1e3 << "\n";
+
+  double add_total{}, update_total{};
+  for (std::size_t i{}; i < batches; ++i)
+  {
+    // Views over rows [i * batch, (i + 1) * batch) of the stream, gathered as a new batch would arrive
+    kc::Columns<N> q;
+    kc::Columns<3> xyz;
+    q.resize(batch);
+    xyz.resize(batch);
+    for (std::size_t c{}; c < N; ++c)
+      std::copy_n(stream_q.column(c) + i * batch, batch, q.data() + c * batch);
+    for (std::size_t c{}; c < 3; ++c)
+      std::copy_n(stream_xyz.column(c) + i * batch, batch, xyz.data() + c * batch);
+
+    const auto start = Clock::now();
+    calibrator.add(q, xyz);
+    const std::chrono::duration<double> add = Clock::now() - start;
+
+    const kc::IncrementalSummary summary = calibrator.update();
+    add_total += add.count();
+    update_total += summary.time_in_seconds;
+
+    if ((i + 1) % 5 != 0 && i != 0) continue;
+    std::cout << std::right << std::setw(9) << summary.samples
+              << std::right << std::fixed << std::setprecision(3) << std::setw(12) << add.count() * 1e3
+              << std::right << std::fixed << std::setprecision(3) << std::setw(13) << summary.time_in_seconds * 1e3
+              << std::right << std::scientific << std::setprecision(2) << std::setw(12) << summary.step_norm
+              << std::right << std::fixed << std::setprecision(4) << std::setw(14) << rmse(calibrator, validation_q, validation_xyz) * 1e3 << "\n";
+  }
+  std::cout << "mean per batch: add " << std::fixed << std::setprecision(3) << add_total / batches * 1e3
+            << " ms, update " << update_total / batches * 1e3 << " ms\n";
+  return 0;
+}
@@ -0,0 +1,281 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "kc/CostFunction.hpp"
+#include "kc/Link.hpp"
+#include "kc/PoseCostFunction.hpp"
+#include "kc/Robot.hpp"
+#include "kc/simd.hpp"
+#include "kc/types.hpp"
+
+// Microbenchmarks of the kinematics hot path in the spirit of Google Benchmark: each kernel is
+// run for doubling iteration counts until it takes at least min_time, and reported in ns/op,
+// heap allocations per op and GFLOP/s (from the nominal floating point operation count of the
+// kernel, trigonometric calls excluded).
+//
+//   ./benchmarks/kernels [--benchmark_filter=<substring>] [--benchmark_format=console|json]
+//                        [--benchmark_out=<file.json>] [--benchmark_min_time=<seconds>]
+
+namespace
+{
+  std::atomic<std::size_t> allocations{0};
+
+  template<class T>
+  inline void do_not_optimize(const T &value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+  using Clock = std::chrono::steady_clock;
+
+  struct Result
+  {
+    std::string name;
+    std::size_t iterations;
+    double      ns_per_op;
+    double      allocations_per_op;
+    double      gflops;
+  };
+
+  struct Runner
+  {
+    std::string         filter;
+    double              min_time{0.2};
+    std::vector<Result> results;
+
+    template<class Kernel>
+    void run(const std::string &name, const double flops, Kernel &&kernel)
+    {
+      if (name.find(this->filter) == std::string::npos) return;
+
+      for (std::size_t iterations{1};; iterations *= 2)
+      {
+        const std::size_t                   before = allocations.load(std::memory_order_relaxed);
+        const auto                          start  = Clock::now();
+        for (std::size_t i{}; i < iterations; ++i)
+          kernel(i);
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        const std::size_t                   after   = allocations.load(std::memory_order_relaxed);
+
+        if (elapsed.count() < this->min_time && iterations < (std::size_t(1) << 40)) continue;
+        const double seconds = elapsed.count() / double(iterations);
+        this->results.push_back({name, iterations, seconds * 1e9, double(after - before) / double(iterations), flops / seconds * 1e-9});
+        return;
+      }
+    }
+  };
+
+  // Nominal operation counts of the kernels
+  constexpr double transform_flops = 7.;   // theta + q, 4 rotation and 2 translation products
+  constexpr double product_flops   = 112.; // 4x4 by 4x4
+  constexpr double link_jacobian   = 51.;  // rotated axes, u, w and the four columns
+  constexpr double fk_flops(const std::size_t n) { return double(n) * (transform_flops + product_flops); }
+  constexpr double jacobian_flops(const std::size_t n) { return double(n) * (transform_flops + product_flops + link_jacobian) + double(n - 1) * 28.; }
+  constexpr double pose_flops(const std::size_t n) { return 45. + 30. + 15. * 4. * double(n); } // R R_m^T, log and J_l^-1 applied to the 4n columns
+
+  // Random DH parameters and a pool of joint configurations cycled through by the kernels
+  template<class Robot>
+  struct Inputs
+  {
+    static constexpr std::size_t N    = Robot::N;
+    static constexpr std::size_t Pool = 1024;
+
+    double                                   a[N], alpha[N], d[N], theta[N];
+    std::vector<typename Robot::JointAngles> q;
+    std::vector<kc::PositionVector>          xyz;
+    std::vector<Eigen::Quaterniond>          orientation;
+
+    Inputs() : q(Pool), xyz(Pool), orientation(Pool)
+    {
+      std::mt19937                           generator{42};
+      std::uniform_real_distribution<double> angle{-M_PI, M_PI};
+      std::uniform_real_distribution<double> length{0., 0.5};
+      for (std::size_t i{}; i < N; ++i)
+      {
+        a[i]     = length(generator);
+        alpha[i] = angle(generator);
+        d[i]     = length(generator);
+        theta[i] = angle(generator);
+      }
+      for (std::size_t sample{}; sample < Pool; ++sample)
+      {
+        for (std::size_t joint{}; joint < N; ++joint)
+          q[sample][joint] = angle(generator);
+        const kc::TransformationMatrix pose = Robot::fk_pose(a, alpha, d, theta, q[sample]);
+        xyz[sample]                         = pose.block<3, 1>(0, 3);
+        orientation[sample]                 = Eigen::Quaterniond{Eigen::Matrix3d{pose.block<3, 3>(0, 0)}};
+      }
+    }
+  };
+
+  template<class Link>
+  void link_benchmarks(Runner &runner, const std::string &name)
+  {
+    const Inputs<kc::Robot<Link>> in;
+    runner.run(name + "/Link::transform", transform_flops, [&](const std::size_t i) {
+      do_not_optimize(Link::transform(in.a[0], in.alpha[0], in.d[0], in.theta[0], in.q[i % in.Pool][0]));
+    });
+  }
+
+  template<class Robot>
+  void robot_benchmarks(Runner &runner, const std::string &name)
+  {
+    constexpr std::size_t N = Robot::N;
+    const Inputs<Robot>   in;
+
+    runner.run(name + "/Robot::fk", fk_flops(N), [&](const std::size_t i) {
+      do_not_optimize(Robot::fk(in.a, in.alpha, in.d, in.theta, in.q[i % in.Pool]));
+    });
+    runner.run(name + "/Robot::jacobian", jacobian_flops(N), [&](const std::size_t i) {
+      do_not_optimize(Robot::jacobian(in.a, in.alpha, in.d, in.theta, in.q[i % in.Pool]));
+    });
+
+    std::vector<std::unique_ptr<ceres::CostFunction>> blocks;
+    for (std::size_t sample{}; sample < in.Pool; ++sample)
+      blocks.emplace_back(kc::CostFunction<Robot>::create(in.q[sample], in.xyz[sample]));
+    const double *const parameters[] = {in.a, in.alpha, in.d, in.theta};
+    double              residuals[3], jacobian_blocks[4][3 * N];
+    double             *jacobians[] = {jacobian_blocks[0], jacobian_blocks[1], jacobian_blocks[2], jacobian_blocks[3]};
+
+    runner.run(name + "/CostFunction::Evaluate", fk_flops(N) + 3., [&](const std::size_t i) {
+      blocks[i % in.Pool]->Evaluate(parameters, residuals, nullptr);
+      do_not_optimize(residuals);
+    });
+    runner.run(name + "/CostFunction::Evaluate+J", jacobian_flops(N) + 3., [&](const std::size_t i) {
+      blocks[i % in.Pool]->Evaluate(parameters, residuals, jacobians);
+      do_not_optimize(residuals);
+      do_not_optimize(jacobian_blocks);
+    });
+
+    runner.run(name + "/Robot::fk_pose_jacobian", jacobian_flops(N), [&](const std::size_t i) {
+      typename Robot::PoseJacobianMatrix jacobian;
+      do_not_optimize(Robot::fk_pose_jacobian(in.a, in.alpha, in.d, in.theta, in.q[i % in.Pool], jacobian));
+      do_not_optimize(jacobian);
+    });
+
+    std::vector<std::unique_ptr<ceres::CostFunction>> pose_blocks;
+    for (std::size_t sample{}; sample < in.Pool; ++sample)
+      pose_blocks.emplace_back(kc::PoseCostFunction<Robot>::create(in.q[sample], in.xyz[sample], in.orientation[sample]));
+    double pose_residuals[6], pose_jacobian_blocks[4][6 * N];
+    double *pose_jacobians[] = {pose_jacobian_blocks[0], pose_jacobian_blocks[1], pose_jacobian_blocks[2], pose_jacobian_blocks[3]};
+
+    runner.run(name + "/PoseCostFunction::Evaluate+J", jacobian_flops(N) + pose_flops(N), [&](const std::size_t i) {
+      pose_blocks[i % in.Pool]->Evaluate(parameters, pose_residuals, pose_jacobians);
+      do_not_optimize(pose_residuals);
+      do_not_optimize(pose_jacobian_blocks);
+    });
+  }
+
+  auto escape(const std::string &text) -> std::string
+  {
+    std::string out;
+    for (const char c : text)
+      out += (c == '"' || c == '\\') ? std::string{'\\', c} : std::string{c};
+    return out;
+  }
+
+  auto to_json(const std::vector<Result> &results) -> std::string
+  {
+    std::ostringstream json;
+    json << std::setprecision(9);
+    json << "{\n  \"context\": {\n"
+         << "    \"simd_width\": " << kc::simd::width << ",\n"
+         << "    \"compiler\": \"" << escape(__VERSION__) << "\"\n"
+         << "  },\n  \"benchmarks\": [\n";
+    for (std::size_t i{}; i < results.size(); ++i)
+    {
+      const Result &result = results[i];
+      json << "    {\n"
+           << "      \"name\": \"" << escape(result.name) << "\",\n"
+           << "      \"iterations\": " << result.iterations << ",\n"
+           << "      \"real_time\": " << result.ns_per_op << ",\n"
+           << "      \"time_unit\": \"ns\",\n"
+           << "      \"allocations_per_iteration\": " << result.allocations_per_op << ",\n"
+           << "      \"gflops\": " << result.gflops << "\n"
+           << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+    return json.str();
+  }
+
+  void print(const std::vector<Result> &results)
+  {
+    std::cout << std::left << std::setw(40) << "benchmark"
+              << std::right << std::setw(12) << "ns/op"
+              << std::right << std::setw(12) << "allocs/op"
+              << std::right << std::setw(10) << "GFLOP/s"
+              << std::right << std::setw(14) << "iterations"
+              << "\n";
+    for (const Result &result : results)
+      std::cout << std::left << std::setw(40) << result.name
+                << std::right << std::fixed << std::setprecision(2) << std::setw(12) << result.ns_per_op
+                << std::right << std::fixed << std::setprecision(2) << std::setw(12) << result.allocations_per_op
+                << std::right << std::fixed << std::setprecision(3) << std::setw(10) << result.gflops
+                << std::right << std::setw(14) << result.iterations << "\n";
+  }
+} // namespace
+
+// Counts every heap allocation made while a kernel runs
+void *operator new(const std::size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+  throw std::bad_alloc{};
+}
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+int main(int argc, char **argv)
+{
+  Runner      runner;
+  std::string format{"console"}, out;
+  for (int i{1}; i < argc; ++i)
+  {
+    const std::string argument{argv[i]};
+    const auto        value = [&](const char *const flag) -> const char * {
+      const std::size_t length = std::strlen(flag);
+      return argument.compare(0, length, flag) == 0 ? argv[i] + length : nullptr;
+    };
+    if (const char *v = value("--benchmark_filter=")) runner.filter = v;
+    else if (const char *v = value("--benchmark_format=")) format = v;
+    else if (const char *v = value("--benchmark_out=")) out = v;
+    else if (const char *v = value("--benchmark_min_time=")) runner.min_time = std::atof(v);
+    else
+    {
+      std::cerr << "unknown argument " << argument << "\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  link_benchmarks<kc::LR>(runner, "Revolute");
+  link_benchmarks<kc::LP>(runner, "Prismatic");
+  robot_benchmarks<kc::Robot<kc::LR, kc::LR, kc::LR>>(runner, "3R");
+  robot_benchmarks<kc::Robot<kc::LR, kc::LR, kc::LP, kc::LR, kc::LR, kc::LR>>(runner, "Stanford");
+  robot_benchmarks<kc::Robot<kc::LR, kc::LR, kc::LR, kc::LR, kc::LR, kc::LR, kc::LR>>(runner, "KUKA");
+
+  if (format == "json")
+    std::cout << to_json(runner.results);
+  else
+    print(runner.results);
+
+  if (!out.empty())
+  {
+    std::ofstream file(out);
+    file << to_json(runner.results);
+    if (!file)
+    {
+      std::cerr << "Could not write " << out << "\n";
+      return EXIT_FAILURE;
+    }
+  }
+  return 0;
+}
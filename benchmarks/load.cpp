@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "KUKA.hpp"
+
+#include "kc/io.hpp"
+#include "kc/types.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int repetitions = 5;
+
+// Reference parser: one pass counting lines then one locale-aware operator>> per value, the
+// way positions were loaded before kc::load_columns.
+auto read_stream(const char *const filename) -> std::vector<kc::PositionVector>
+{
+  std::ifstream     istrm(filename, std::ios::in);
+  const std::size_t n_lines = static_cast<std::size_t>(
+      std::count(std::istreambuf_iterator<char>(istrm), std::istreambuf_iterator<char>(), '\n'));
+  istrm.clear();
+  istrm.seekg(0);
+
+  std::vector<kc::PositionVector> out;
+  out.reserve(n_lines);
+  kc::PositionVector xyz;
+  while (istrm >> xyz)
+    out.emplace_back(xyz);
+  return out;
+}
+
+void print(const char *const name, const double seconds, const std::size_t rows, const std::size_t bytes, const double reference)
+{
+  std::cout << std::left << std::setw(16) << name
+            << std::right << std::fixed << std::setprecision(3) << std::setw(12) << seconds * 1e3
+            << std::right << std::fixed << std::setprecision(2) << std::setw(12) << double(rows) / seconds * 1e-6
+            << std::right << std::fixed << std::setprecision(1) << std::setw(12) << double(bytes) / seconds * 1e-6
+            << std::right << std::fixed << std::setprecision(2) << std::setw(10) << reference / seconds << "\n";
+}
+
+int main(void)
+{
+  std::ifstream     istrm(P_KUKA, std::ios::binary | std::ios::ate);
+  const std::size_t bytes = static_cast<std::size_t>(istrm.tellg());
+
+  double                          stream_time{1e30};
+  std::vector<kc::PositionVector> reference;
+  for (int repetition{}; repetition < repetitions; ++repetition)
+  {
+    const auto start = Clock::now();
+    reference        = read_stream(P_KUKA);
+    stream_time      = std::min(stream_time, std::chrono::duration<double>(Clock::now() - start).count());
+  }
+
+  std::cout << P_KUKA << ": " << reference.size() << " rows, " << bytes << " bytes, best of " << repetitions << "\n";
+  std::cout << std::left << std::setw(16) << "loader"
+            << std::right << std::setw(12) << "time [ms]"
+            << std::right << std::setw(12) << "Mrow/s"
+            << std::right << std::setw(12) << "MB/s"
+            << std::right << std::setw(10) << "speedup"
+            << "\n";
+  print("operator>>", stream_time, reference.size(), bytes, stream_time);
+
+  const std::size_t max_threads = std::max(1U, std::thread::hardware_concurrency());
+  for (std::size_t threads{1}; threads <= max_threads; threads *= 2)
+  {
+    double         time{1e30};
+    kc::Columns<3> xyz;
+    for (int repetition{}; repetition < repetitions; ++repetition)
+    {
+      const auto start = Clock::now();
+      if (const auto status = kc::load_columns(P_KUKA, xyz, threads); !status)
+      {
+        std::cerr << status.message << "\n";
+        return EXIT_FAILURE;
+      }
+      time = std::min(time, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+
+    bool matches = xyz.rows() == reference.size();
+    for (std::size_t i{}; matches && i < xyz.rows(); ++i)
+      matches = xyz.row(i) == reference[i];
+    if (!matches)
+    {
+      std::cerr << "load_columns with " << threads << " threads differs from operator>>\n";
+      return EXIT_FAILURE;
+    }
+
+    const std::string name = "from_chars x" + std::to_string(threads);
+    print(name.c_str(), time, xyz.rows(), bytes, stream_time);
+  }
+  return 0;
+}
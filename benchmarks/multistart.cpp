@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "kc/NativeCalibrator.hpp"
+#include "kc/evaluate.hpp"
+#include "kc/io.hpp"
+#include "kc/multistart.hpp"
+
+#include "synthetic.hpp"
+
+using KUKA = synthetic::KUKA;
+
+using synthetic::N;
+using synthetic::nominal_a;
+using synthetic::nominal_alpha;
+using synthetic::nominal_d;
+using synthetic::nominal_theta;
+
+constexpr std::size_t samples = 63500; // as many as data/P_KUKA.txt
+
+int main(void)
+{
+  kc::Columns<N> joint_angles;
+  kc::Columns<3> xyz;
+  synthetic::generate(synthetic::Parameters{}, samples, joint_angles, xyz);
+  const std::size_t split = std::size_t(double(samples) * kc::NativeOptions{}.training_fraction);
+
+  const kc::MultiStartOptions options;
+  std::cout << "KUKA calibration from the nominal parameters with one angle a quarter turn out, "
+            << options.starts << " starts, " << options.survivors << " survivors, " << options.num_threads << " threads\n";
+  std::cout << std::left << std::setw(14) << "wrong angle"
+            << std::right << std::setw(18) << "single RMSE [mm]"
+            << std::right << std::setw(10) << "time [s]"
+            << std::right << std::setw(18) << "multi RMSE [mm]"
+            << std::right << std::setw(10) << "time [s]"
+            << std::right << std::setw(8) << "probes"
+            << std::right << std::setw(12) << "best start"
+            << "\n";
+
+  // Links and blocks (1: alpha, 3: theta) of the angles from which a single solve ends in a local
+  // minimum, and the correct guess for reference
+  const std::pair<int, std::size_t> wrong[] = {{-1, 0}, {1, 1}, {1, 2}, {1, 4}, {1, 5}, {3, 5}, {3, 6}};
+  for (const auto &[block, link] : wrong)
+  {
+    double a[N], alpha[N], d[N], theta[N];
+    std::copy_n(nominal_a, N, a);
+    std::copy_n(nominal_alpha, N, alpha);
+    std::copy_n(nominal_d, N, d);
+    std::copy_n(nominal_theta, N, theta);
+    if (block >= 0)
+    {
+      double &angle = block == 1 ? alpha[link] : theta[link];
+      angle         = std::fmod(angle + M_PI / 2., 2. * M_PI);
+    }
+
+    double single_a[N], single_alpha[N], single_d[N], single_theta[N];
+    std::copy_n(a, N, single_a);
+    std::copy_n(alpha, N, single_alpha);
+    std::copy_n(d, N, single_d);
+    std::copy_n(theta, N, single_theta);
+    kc::NativeCalibrator<KUKA> calibrator(joint_angles, xyz, single_a, single_alpha, single_d, single_theta);
+    const kc::NativeSummary    summary = calibrator.solve();
+    const kc::Evaluation       single  = kc::evaluate<KUKA>(single_a, single_alpha, single_d, single_theta, joint_angles, xyz, split, samples);
+
+    const kc::MultiStart multi = kc::multi_start<KUKA>(a, alpha, d, theta, joint_angles, xyz, options);
+
+    const std::string name = block < 0 ? "none" : (block == 1 ? "alpha" : "theta") + std::to_string(link) + " + pi/2";
+    std::cout << std::left << std::setw(14) << name
+              << std::right << std::fixed << std::setprecision(4) << std::setw(18) << single.rmse * 1e3
+              << std::right << std::fixed << std::setprecision(2) << std::setw(10) << summary.total_time_in_seconds
+              << std::right << std::fixed << std::setprecision(4) << std::setw(18) << multi.candidates.front().validation.rmse * 1e3
+              << std::right << std::fixed << std::setprecision(2) << std::setw(10) << multi.time_in_seconds
+              << std::right << std::setw(8) << multi.probes
+              << std::right << std::setw(12) << multi.candidates.front().start
+              << "\n";
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "kc/Calibrator.hpp"
+#include "kc/NativeCalibrator.hpp"
+#include "kc/evaluate.hpp"
+#include "kc/io.hpp"
+
+#include "ceres/ceres.h"
+
+#include "synthetic.hpp"
+
+using KUKA = synthetic::KUKA;
+
+using synthetic::N;
+using synthetic::nominal_a;
+using synthetic::nominal_alpha;
+using synthetic::nominal_d;
+using synthetic::nominal_theta;
+
+constexpr std::size_t samples = 63500; // as many as data/P_KUKA.txt
+
+struct Result
+{
+  double time{}, initial_cost{}, final_cost{};
+  int    iterations{};
+};
+
+// Runs solver in a child process, so that its peak resident set is measured apart from the
+// others, and prints one row of the table. The dataset is shared with the child copy-on-write.
+void run(const char *name, const std::function<Result(double *, double *, double *, double *)> &solver,
+         const kc::Columns<N> &joint_angles, const kc::Columns<3> &xyz)
+{
+  std::cout.flush();
+  const pid_t child = fork();
+  if (child == 0)
+  {
+    double a[N], alpha[N], d[N], theta[N];
+    std::copy_n(nominal_a, N, a);
+    std::copy_n(nominal_alpha, N, alpha);
+    std::copy_n(nominal_d, N, d);
+    std::copy_n(nominal_theta, N, theta);
+
+    const Result         result = solver(a, alpha, d, theta);
+    const std::size_t    split  = std::size_t(double(samples) * 0.8);
+    const kc::Evaluation held   = kc::evaluate<KUKA>(a, alpha, d, theta, joint_angles, xyz, split, samples);
+    std::cout << std::left << std::setw(22) << name
+              << std::right << std::setw(6) << result.iterations
+              << std::right << std::fixed << std::setprecision(3) << std::setw(10) << result.time
+              << std::right << std::scientific << std::setprecision(6) << std::setw(16) << result.final_cost
+              << std::right << std::fixed << std::setprecision(4) << std::setw(12) << held.rmse * 1e3;
+    std::cout.flush();
+    std::_Exit(EXIT_SUCCESS);
+  }
+
+  int    status{};
+  rusage usage{};
+  wait4(child, &status, 0, &usage);
+  std::cout << std::right << std::setw(12) << usage.ru_maxrss / 1024 << "\n";
+}
+
+int main(void)
+{
+  kc::Columns<N> joint_angles;
+  kc::Columns<3> xyz;
+  synthetic::generate(synthetic::Parameters{}, samples, joint_angles, xyz);
+
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  std::cout << "KUKA calibration from the nominal parameters, " << std::size_t(double(samples) * 0.8) << " training samples, "
+            << "dataset process " << usage.ru_maxrss / 1024 << " MiB\n";
+  std::cout << std::left << std::setw(22) << "solver"
+            << std::right << std::setw(6) << "iter"
+            << std::right << std::setw(10) << "time [s]"
+            << std::right << std::setw(16) << "final cost"
+            << std::right << std::setw(12) << "RMSE [mm]"
+            << std::right << std::setw(12) << "peak [MiB]"
+            << "\n";
+
+  const std::pair<ceres::LinearSolverType, const char *> solvers[] = {{ceres::DENSE_QR, "ceres DENSE_QR"},
+                                                                      {ceres::DENSE_NORMAL_CHOLESKY, "ceres DENSE_NORMAL"}};
+  for (const auto &[type, name] : solvers)
+    run(name, [&, type = type](double *a, double *alpha, double *d, double *theta) {
+      kc::CalibrationOptions options;
+      options.linear_solver_type = type;
+      kc::Calibrator<KUKA>         calibrator(joint_angles, xyz, a, alpha, d, theta, options);
+      const ceres::Solver::Summary summary = calibrator.solve();
+      return Result{summary.total_time_in_seconds, summary.initial_cost, summary.final_cost,
+                    summary.num_successful_steps + summary.num_unsuccessful_steps};
+    }, joint_angles, xyz);
+
+  run("kc::NativeCalibrator", [&](double *a, double *alpha, double *d, double *theta) {
+    kc::NativeCalibrator<KUKA> calibrator(joint_angles, xyz, a, alpha, d, theta);
+    const kc::NativeSummary    summary = calibrator.solve();
+    return Result{summary.total_time_in_seconds, summary.initial_cost, summary.final_cost, summary.iterations};
+  }, joint_angles, xyz);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "kc/Robot.hpp"
+#include "kc/evaluate.hpp"
+#include "kc/io.hpp"
+
+#include "ceres/ceres.h"
+
+#include "synthetic.hpp"
+
+using KUKA  = synthetic::KUKA;
+using Clock = std::chrono::steady_clock;
+
+using synthetic::N;
+
+constexpr std::size_t samples     = 1 << 20;
+constexpr int         repetitions = 5;
+
+// Best of a few runs of f, in seconds
+template<class F>
+auto best_time(const F &f) -> double
+{
+  double best{1e300};
+  for (int run{}; run < repetitions; ++run)
+  {
+    const auto start = Clock::now();
+    f();
+    best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+  }
+  return best;
+}
+
+int main(void)
+{
+  const synthetic::Parameters truth;
+  kc::Columns<N>              joint_angles;
+  kc::Columns<3>              xyz;
+  synthetic::generate(truth, samples, joint_angles, xyz);
+
+  std::cout << "KUKA, " << samples << " samples at the true parameters, one thread\n\n";
+
+  // Forward kinematics alone: double throughout, float data, and double data through float lanes
+  std::vector<float>  q_float(joint_angles.data(), joint_angles.data() + N * samples), xyz_float(3 * samples);
+  std::vector<double> xyz_double(3 * samples), xyz_mixed(3 * samples);
+  const double        double_time = best_time([&] {
+    KUKA::fk_batch(truth.a, truth.alpha, truth.d, truth.theta, joint_angles.data(), samples, xyz_double.data());
+  });
+  const double        float_time  = best_time([&] {
+    KUKA::fk_batch(truth.a, truth.alpha, truth.d, truth.theta, q_float.data(), samples, xyz_float.data());
+  });
+  const double        mixed_time  = best_time([&] {
+    KUKA::fk_batch<double, float>(truth.a, truth.alpha, truth.d, truth.theta, joint_angles.data(), samples, xyz_mixed.data());
+  });
+  double              float_discrepancy{}, mixed_discrepancy{};
+  for (std::size_t i{}; i < 3 * samples; ++i)
+  {
+    float_discrepancy = std::max(float_discrepancy, std::abs(double(xyz_float[i]) - xyz_double[i]));
+    mixed_discrepancy = std::max(mixed_discrepancy, std::abs(xyz_mixed[i] - xyz_double[i]));
+  }
+
+  std::cout << std::left << std::setw(22) << "Robot::fk_batch"
+            << std::right << std::setw(8) << "lanes"
+            << std::right << std::setw(14) << "ns/sample"
+            << std::right << std::setw(18) << "max |dp| [m]" << "\n";
+  std::cout << std::left << std::setw(22) << "  double"
+            << std::right << std::setw(8) << kc::simd::lanes<double>
+            << std::right << std::fixed << std::setprecision(2) << std::setw(14) << double_time / samples * 1e9 << "\n";
+  std::cout << std::left << std::setw(22) << "  float"
+            << std::right << std::setw(8) << kc::simd::lanes<float>
+            << std::right << std::fixed << std::setprecision(2) << std::setw(14) << float_time / samples * 1e9
+            << std::right << std::scientific << std::setprecision(2) << std::setw(18) << float_discrepancy << "\n";
+  std::cout << std::left << std::setw(22) << "  <double, float>"
+            << std::right << std::setw(8) << kc::simd::lanes<float>
+            << std::right << std::fixed << std::setprecision(2) << std::setw(14) << mixed_time / samples * 1e9
+            << std::right << std::scientific << std::setprecision(2) << std::setw(18) << mixed_discrepancy << "\n\n";
+
+  // Validation sweeps, including the error statistics; the last row tightens the accuracy guard
+  // until it rejects the float pass and the sweep is repeated in double
+  std::cout << std::left << std::setw(22) << "kc::evaluate"
+            << std::right << std::setw(10) << "ran in"
+            << std::right << std::setw(12) << "time [ms]"
+            << std::right << std::setw(14) << "RMSE [mm]"
+            << std::right << std::setw(18) << "RMSE change" << "\n";
+  kc::EvaluationOptions options;
+  options.num_threads        = 1;
+  const kc::Evaluation exact = kc::evaluate<KUKA>(truth.a, truth.alpha, truth.d, truth.theta, joint_angles, xyz, 0, samples, options);
+
+  const std::pair<const char *, double> modes[] = {{"  Double", 0.}, {"  Mixed", 0.05}, {"  Mixed, guard 1e-3", 1e-3}};
+  for (const auto &[name, tolerance] : modes)
+  {
+    options.precision                  = tolerance > 0. ? kc::Precision::Mixed : kc::Precision::Double;
+    options.single_precision_tolerance = tolerance;
+    kc::Evaluation evaluation;
+    const double   time = best_time([&] {
+      evaluation = kc::evaluate<KUKA>(truth.a, truth.alpha, truth.d, truth.theta, joint_angles, xyz, 0, samples, options);
+    });
+    std::cout << std::left << std::setw(22) << name
+              << std::right << std::setw(10) << (evaluation.precision == kc::Precision::Mixed ? "float" : "double")
+              << std::right << std::fixed << std::setprecision(2) << std::setw(12) << time * 1e3
+              << std::right << std::fixed << std::setprecision(6) << std::setw(14) << evaluation.rmse * 1e3
+              << std::right << std::scientific << std::setprecision(2) << std::setw(18) << std::abs(evaluation.rmse - exact.rmse) / exact.rmse << "\n";
+  }
+
+  // The analytic position Jacobian against forward-mode automatic differentiation of fk, column
+  // 4 link + block of both being the derivative with respect to that DH parameter
+  using Jet = ceres::Jet<double, 4 * N>;
+  Jet a[N], alpha[N], d[N], theta[N];
+  for (std::size_t link{}; link < N; ++link)
+  {
+    a[link]     = Jet{truth.a[link], int(4 * link)};
+    alpha[link] = Jet{truth.alpha[link], int(4 * link + 1)};
+    d[link]     = Jet{truth.d[link], int(4 * link + 2)};
+    theta[link] = Jet{truth.theta[link], int(4 * link + 3)};
+  }
+  double jacobian_error{};
+  for (std::size_t sample{}; sample < 1000; ++sample)
+  {
+    const KUKA::JointAngles        q        = joint_angles.row(sample * (samples / 1000));
+    const KUKA::JacobianMatrix     analytic = KUKA::jacobian(truth.a, truth.alpha, truth.d, truth.theta, q);
+    const kc::PositionVectorT<Jet> p        = KUKA::fk(a, alpha, d, theta, q.cast<Jet>());
+    for (std::size_t row{}; row < 3; ++row)
+      jacobian_error = std::max(jacobian_error, (analytic.row(Eigen::Index(row)).transpose() - p[row].v).cwiseAbs().maxCoeff());
+  }
+  std::cout << "\nRobot::jacobian against Robot::fk<ceres::Jet>, 1000 samples: max |dJ| "
+            << std::scientific << std::setprecision(2) << jacobian_error << "\n";
+  return EXIT_SUCCESS;
+}
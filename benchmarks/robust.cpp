@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "kc/Calibrator.hpp"
+#include "kc/evaluate.hpp"
+#include "kc/io.hpp"
+#include "kc/robust.hpp"
+
+#include "synthetic.hpp"
+
+#include "ceres/ceres.h"
+
+using KUKA  = synthetic::KUKA;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t N        = synthetic::N;
+constexpr std::size_t samples  = 1 << 16;
+constexpr double      outliers = 0.01; // fraction of corrupted tracker frames
+
+struct Run
+{
+  std::string name;
+  std::size_t rejected{}, iterations{};
+  double      seconds{}, rmse{}, parameter_error{};
+};
+
+// Calibrates synthetic KUKA logs in which 1% of the tracker frames are off by 1 to 10 cm, once
+// with plain least squares, once after outlier screening and once with screening followed by
+// Huber and Cauchy reweighting. The validation RMSE is taken over the clean frames only.
+int main(void)
+{
+  const synthetic::Parameters truth;
+
+  kc::Columns<N> joint_angles;
+  kc::Columns<3> xyz;
+  synthetic::generate(truth, samples, joint_angles, xyz);
+
+  // measured repeats the synthetic log (same seed) with a random subset of frames corrupted; xyz
+  // stays clean for validation
+  std::mt19937                           generator{3};
+  std::bernoulli_distribution            corrupt{outliers};
+  std::uniform_real_distribution<double> offset{0.01, 0.1};
+  std::normal_distribution<double>       direction{0., 1.};
+  kc::Columns<3>                         measured;
+  std::vector<bool>                      clean(samples, true);
+  synthetic::generate(truth, samples, joint_angles, measured);
+  for (std::size_t i{}; i < samples; ++i)
+  {
+    if (!corrupt(generator)) continue;
+    clean[i] = false;
+    Eigen::Vector3d u{direction(generator), direction(generator), direction(generator)};
+    u = u.normalized() * offset(generator);
+    for (std::size_t axis{}; axis < 3; ++axis)
+      measured.data()[axis * samples + i] += u[Eigen::Index(axis)];
+  }
+  const std::size_t corrupted = std::size_t(std::count(clean.begin(), clean.end(), false));
+
+  kc::CalibrationOptions calibration;
+  calibration.max_num_iterations = 100;
+
+  const auto validate = [&](Run &run, const double *a, const double *alpha, const double *d, const double *theta) {
+    const std::size_t   training = std::size_t(double(samples) * calibration.training_fraction);
+    std::vector<double> errors   = kc::position_errors<KUKA>(a, alpha, d, theta, joint_angles, xyz, 0, samples);
+    double              squared{};
+    std::size_t         count{};
+    for (std::size_t i{training}; i < samples; ++i)
+      if (clean[i])
+      {
+        squared += errors[i] * errors[i];
+        ++count;
+      }
+    run.rmse = std::sqrt(squared / double(std::max<std::size_t>(1, count)));
+    for (std::size_t i{}; i < N; ++i)
+      run.parameter_error = std::max({run.parameter_error, std::abs(a[i] - truth.a[i]), std::abs(alpha[i] - truth.alpha[i]),
+                                      std::abs(d[i] - truth.d[i]), std::abs(theta[i] - truth.theta[i])});
+  };
+
+  std::vector<Run> runs;
+  {
+    double a[N], alpha[N], d[N], theta[N];
+    std::copy_n(synthetic::nominal_a, N, a);
+    std::copy_n(synthetic::nominal_alpha, N, alpha);
+    std::copy_n(synthetic::nominal_d, N, d);
+    std::copy_n(synthetic::nominal_theta, N, theta);
+
+    Run        run{"least squares"};
+    const auto start = Clock::now();
+    kc::Calibrator<KUKA>         calibrator(joint_angles, measured, a, alpha, d, theta, calibration);
+    const ceres::Solver::Summary summary = calibrator.solve();
+    run.seconds    = std::chrono::duration<double>(Clock::now() - start).count();
+    run.iterations = summary.iterations.size();
+    validate(run, a, alpha, d, theta);
+    runs.push_back(run);
+  }
+
+  const std::pair<kc::Loss, const char *> losses[] = {{kc::Loss::Trivial, "screened"}, {kc::Loss::Huber, "screened + Huber"}, {kc::Loss::Cauchy, "screened + Cauchy"}};
+  for (const auto &[loss, name] : losses)
+  {
+    double a[N], alpha[N], d[N], theta[N];
+    std::copy_n(synthetic::nominal_a, N, a);
+    std::copy_n(synthetic::nominal_alpha, N, alpha);
+    std::copy_n(synthetic::nominal_d, N, d);
+    std::copy_n(synthetic::nominal_theta, N, theta);
+
+    kc::RobustOptions options;
+    options.loss = loss;
+
+    Run                         run{name};
+    const auto                  start  = Clock::now();
+    const kc::RobustCalibration result = kc::robust_calibrate<KUKA>(joint_angles, measured, a, alpha, d, theta, calibration, options);
+    run.seconds                        = std::chrono::duration<double>(Clock::now() - start).count();
+    run.rejected                       = result.screening.rejected;
+    for (const auto &summary : result.summaries)
+      run.iterations += summary.iterations.size();
+    validate(run, a, alpha, d, theta);
+    runs.push_back(run);
+  }
+
+  std::cout << samples << " synthetic KUKA samples, " << corrupted << " corrupted frames\n";
+  std::cout << std::left << std::setw(20) << "method"
+            << std::right << std::setw(10) << "rejected"
+            << std::right << std::setw(12) << "iterations"
+            << std::right << std::setw(10) << "time [s]"
+            << std::right << std::setw(14) << "rmse [mm]"
+            << std::right << std::setw(18) << "max |p - truth|"
+            << "\n";
+  for (const Run &run : runs)
+    std::cout << std::left << std::setw(20) << run.name
+              << std::right << std::setw(10) << run.rejected
+              << std::right << std::setw(12) << run.iterations
+              << std::right << std::fixed << std::setprecision(3) << std::setw(10) << run.seconds
+              << std::right << std::fixed << std::setprecision(4) << std::setw(14) << run.rmse * 1e3
+              << std::right << std::scientific << std::setprecision(2) << std::setw(18) << run.parameter_error << "\n";
+  return 0;
+}
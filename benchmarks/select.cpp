@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "kc/Calibrator.hpp"
+#include "kc/evaluate.hpp"
+#include "kc/io.hpp"
+#include "kc/select.hpp"
+
+#include "synthetic.hpp"
+
+#include "ceres/ceres.h"
+
+using KUKA  = synthetic::KUKA;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t N       = synthetic::N;
+constexpr std::size_t samples = 63500;
+
+struct Run
+{
+  std::string name;
+  std::size_t samples{}, iterations{};
+  double      select_seconds{}, solve_seconds{}, rmse{}, efficiency{};
+};
+
+// Calibrates on a slow synthetic KUKA trajectory, whose consecutive poses differ by little as in
+// data/P_KUKA.txt, once on every training sample and once on K-sample subsets picked by
+// kc::select_samples (and, for comparison, uniformly at random). Every fit starts from the
+// nominal parameters and is validated on the same held-out tail of the trajectory.
+int main(void)
+{
+  const synthetic::Parameters truth;
+
+  kc::Columns<N> joint_angles;
+  kc::Columns<3> xyz;
+  joint_angles.resize(samples);
+  xyz.resize(samples);
+  std::mt19937                           generator{5};
+  std::uniform_real_distribution<double> frequency{0.2, 1.}, phase{0., 2. * M_PI};
+  std::normal_distribution<double>       tracker{0., 1e-4};
+  for (std::size_t joint{}; joint < N; ++joint)
+  {
+    const double omega = frequency(generator) * 2. * M_PI / 5000., phi = phase(generator);
+    for (std::size_t i{}; i < samples; ++i)
+      joint_angles.data()[joint * samples + i] = 0.9 * M_PI * std::sin(omega * double(i) + phi);
+  }
+  KUKA::fk_batch(truth.a, truth.alpha, truth.d, truth.theta, joint_angles.data(), samples, xyz.data());
+  std::for_each(xyz.data(), xyz.data() + 3 * samples, [&](double &value) { value += tracker(generator); });
+
+  kc::CalibrationOptions calibration;
+  calibration.max_num_iterations = 100;
+  const std::size_t training     = std::size_t(double(samples) * calibration.training_fraction);
+
+  const auto solve = [&](Run &run, const kc::ColumnsView<N> &q, const kc::ColumnsView<3> &p, const double fraction) {
+    double a[N], alpha[N], d[N], theta[N];
+    std::copy_n(synthetic::nominal_a, N, a);
+    std::copy_n(synthetic::nominal_alpha, N, alpha);
+    std::copy_n(synthetic::nominal_d, N, d);
+    std::copy_n(synthetic::nominal_theta, N, theta);
+
+    kc::CalibrationOptions options = calibration;
+    options.training_fraction      = fraction;
+
+    const auto                   start = Clock::now();
+    kc::Calibrator<KUKA>         calibrator(q, p, a, alpha, d, theta, options);
+    const ceres::Solver::Summary summary = calibrator.solve();
+    run.solve_seconds                    = std::chrono::duration<double>(Clock::now() - start).count();
+    run.iterations                       = summary.iterations.size();
+    run.samples                          = calibrator.training_samples();
+    run.rmse                             = kc::evaluate<KUKA>(a, alpha, d, theta, joint_angles, xyz, training, samples).rmse;
+  };
+
+  std::vector<Run> runs;
+  runs.push_back({"all samples"});
+  solve(runs.back(), joint_angles, xyz, calibration.training_fraction);
+  runs.back().efficiency = 1.;
+
+  for (const std::size_t K : {250, 500, 1000, 2000})
+  {
+    Run        run{"D-optimal " + std::to_string(K)};
+    const auto start = Clock::now();
+    const kc::Selection selection = kc::select_samples<KUKA>(synthetic::nominal_a, synthetic::nominal_alpha, synthetic::nominal_d,
+                                                             synthetic::nominal_theta, joint_angles, 0, training, K);
+    run.select_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    run.efficiency     = selection.efficiency;
+    solve(run, kc::gather(joint_angles.view(), selection.samples), kc::gather(xyz.view(), selection.samples), 1.);
+    runs.push_back(run);
+  }
+
+  {
+    std::vector<std::size_t> shuffled(training);
+    std::iota(shuffled.begin(), shuffled.end(), 0);
+    std::shuffle(shuffled.begin(), shuffled.end(), generator);
+    shuffled.resize(500);
+    std::sort(shuffled.begin(), shuffled.end());
+
+    Run run{"random 500"};
+    solve(run, kc::gather(joint_angles.view(), shuffled), kc::gather(xyz.view(), shuffled), 1.);
+    runs.push_back(run);
+  }
+
+  const double baseline = runs.front().solve_seconds;
+  std::cout << samples << " synthetic KUKA trajectory samples, " << training << " for training\n";
+  std::cout << std::left << std::setw(16) << "subset"
+            << std::right << std::setw(9) << "samples"
+            << std::right << std::setw(12) << "select [s]"
+            << std::right << std::setw(11) << "solve [s]"
+            << std::right << std::setw(12) << "iterations"
+            << std::right << std::setw(10) << "speedup"
+            << std::right << std::setw(12) << "D-eff."
+            << std::right << std::setw(14) << "rmse [mm]"
+            << "\n";
+  for (const Run &run : runs)
+    std::cout << std::left << std::setw(16) << run.name
+              << std::right << std::setw(9) << run.samples
+              << std::right << std::fixed << std::setprecision(3) << std::setw(12) << run.select_seconds
+              << std::right << std::fixed << std::setprecision(3) << std::setw(11) << run.solve_seconds
+              << std::right << std::setw(12) << run.iterations
+              << std::right << std::fixed << std::setprecision(1) << std::setw(10) << baseline / (run.select_seconds + run.solve_seconds)
+              << std::right << std::fixed << std::setprecision(2) << std::setw(12) << run.efficiency
+              << std::right << std::fixed << std::setprecision(4) << std::setw(14) << run.rmse * 1e3 << "\n";
+  return 0;
+}
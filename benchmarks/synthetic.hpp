@@ -0,0 +1,62 @@
+#ifndef KC_BENCHMARKS_SYNTHETIC_HPP_
+#define KC_BENCHMARKS_SYNTHETIC_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "kc/Robot.hpp"
+#include "kc/io.hpp"
+
+// Synthetic KUKA measurements for the benchmarks, data/Q_KUKA.txt not being part of the tree.
+namespace synthetic
+{
+  using KUKA = kc::Robot<kc::LR, kc::LR, kc::LR, kc::LR, kc::LR, kc::LR, kc::LR>;
+
+  constexpr std::size_t N = KUKA::N;
+
+  // clang-format off
+  constexpr double nominal_a[]     = {      0,      0,      0,      0,      0,      0,     0 };
+  constexpr double nominal_alpha[] = { M_PI_2, M_PI_2, M_PI_2, M_PI_2, M_PI_2, M_PI_2,     0 };
+  constexpr double nominal_d[]     = {   0.34,      0,    0.4,      0,    0.4,      0, 0.126 };
+  constexpr double nominal_theta[] = {   M_PI,   M_PI,      0,   M_PI,      0,   M_PI,     0 };
+  // clang-format on
+
+  // "True" DH parameters of the simulated arm: the nominal ones offset by up to a millimetre or
+  // a milliradian.
+  struct Parameters
+  {
+    double a[N], alpha[N], d[N], theta[N];
+
+    explicit Parameters(const unsigned seed = 7)
+    {
+      std::mt19937                           generator{seed};
+      std::uniform_real_distribution<double> offset{0., 1e-3};
+      for (std::size_t i{}; i < N; ++i)
+      {
+        a[i]     = nominal_a[i] + offset(generator);
+        alpha[i] = nominal_alpha[i] + offset(generator);
+        d[i]     = nominal_d[i] + offset(generator);
+        theta[i] = nominal_theta[i] + offset(generator);
+      }
+    }
+  };
+
+  // samples random joint configurations and their end-effector positions under truth, with
+  // Gaussian tracker noise of standard deviation noise.
+  inline void generate(const Parameters &truth, const std::size_t samples, kc::Columns<N> &joint_angles, kc::Columns<3> &xyz,
+                       const unsigned seed = 42, const double noise = 1e-4)
+  {
+    std::mt19937                           generator{seed};
+    std::uniform_real_distribution<double> angle{-M_PI, M_PI};
+    std::normal_distribution<double>       tracker{0., noise};
+
+    joint_angles.resize(samples);
+    xyz.resize(samples);
+    std::generate_n(joint_angles.data(), N * samples, [&] { return angle(generator); });
+    KUKA::fk_batch(truth.a, truth.alpha, truth.d, truth.theta, joint_angles.data(), samples, xyz.data());
+    std::for_each(xyz.data(), xyz.data() + 3 * samples, [&](double &value) { value += tracker(generator); });
+  }
+} // namespace synthetic
+
+#endif // KC_BENCHMARKS_SYNTHETIC_HPP_
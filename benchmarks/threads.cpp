@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "kc/Calibrator.hpp"
+#include "kc/CostFunction.hpp"
+#include "kc/Robot.hpp"
+#include "kc/io.hpp"
+#include "kc/types.hpp"
+
+#include "ceres/ceres.h"
+
+#include "synthetic.hpp"
+
+using KUKA  = synthetic::KUKA;
+using Clock = std::chrono::steady_clock;
+
+using synthetic::N;
+using synthetic::nominal_a;
+using synthetic::nominal_alpha;
+using synthetic::nominal_d;
+using synthetic::nominal_theta;
+
+constexpr std::size_t samples = 63500; // as many as data/P_KUKA.txt
+
+// Evaluates every residual block (residuals and all four Jacobian blocks) on T threads, each
+// writing its own slice of out, and returns the elapsed time.
+auto evaluate(const std::vector<std::unique_ptr<ceres::CostFunction>> &blocks, const double *const *parameters,
+              const std::size_t threads, std::vector<double> &out) -> double
+{
+  constexpr std::size_t stride = 3 + 4 * 3 * N;
+
+  const auto task = [&](const std::size_t thread) {
+    const std::size_t begin = blocks.size() * thread / threads, end = blocks.size() * (thread + 1) / threads;
+    for (std::size_t i{begin}; i < end; ++i)
+    {
+      double *const residuals   = out.data() + i * stride;
+      double       *jacobians[] = {residuals + 3, residuals + 3 + 3 * N, residuals + 3 + 6 * N, residuals + 3 + 9 * N};
+      blocks[i]->Evaluate(parameters, residuals, jacobians);
+    }
+  };
+
+  const auto               start = Clock::now();
+  std::vector<std::thread> workers;
+  for (std::size_t thread{1}; thread < threads; ++thread)
+    workers.emplace_back(task, thread);
+  task(0);
+  for (auto &worker : workers)
+    worker.join();
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(void)
+{
+  kc::Columns<N> joint_angles;
+  kc::Columns<3> xyz;
+  synthetic::generate(synthetic::Parameters{}, samples, joint_angles, xyz);
+
+  const std::size_t max_threads = std::max(1U, std::thread::hardware_concurrency());
+  std::vector<std::size_t> thread_counts;
+  for (std::size_t threads{1}; threads < max_threads; threads *= 2)
+    thread_counts.push_back(threads);
+  thread_counts.push_back(max_threads);
+
+  // CostFunction::Evaluate from concurrent threads must match the serial evaluation exactly
+  std::vector<std::unique_ptr<ceres::CostFunction>> blocks;
+  for (std::size_t i{}; i < samples; ++i)
+    blocks.emplace_back(kc::CostFunction<KUKA>::create(joint_angles.row(i), xyz.row(i)));
+  const double *const parameters[] = {nominal_a, nominal_alpha, nominal_d, nominal_theta};
+
+  std::vector<double> reference(samples * (3 + 12 * N)), out(reference.size());
+  const double        serial = evaluate(blocks, parameters, 1, reference);
+
+  std::cout << "CostFunction::Evaluate with Jacobians, " << samples << " samples\n";
+  std::cout << std::right << std::setw(8) << "threads"
+            << std::right << std::setw(14) << "Meval/s"
+            << std::right << std::setw(10) << "speedup"
+            << std::right << std::setw(12) << "identical"
+            << "\n";
+  bool identical{true};
+  for (const std::size_t threads : thread_counts)
+  {
+    std::fill(out.begin(), out.end(), 0.);
+    const double time = evaluate(blocks, parameters, threads, out);
+    const bool   same = out == reference;
+    identical         = identical && same;
+    std::cout << std::right << std::setw(8) << threads
+              << std::right << std::fixed << std::setprecision(2) << std::setw(14) << double(samples) / time * 1e-6
+              << std::right << std::fixed << std::setprecision(2) << std::setw(10) << serial / time
+              << std::right << std::setw(12) << (same ? "yes" : "NO") << "\n";
+  }
+
+  std::cout << "\nkc::Calibrator solve, 10 iterations, " << std::size_t(double(samples) * 0.8) << " training samples\n";
+  std::cout << std::right << std::setw(8) << "threads"
+            << std::right << std::setw(12) << "solver"
+            << std::right << std::setw(15) << "s / iteration"
+            << std::right << std::setw(10) << "speedup"
+            << std::right << std::setw(16) << "final cost"
+            << "\n";
+  const std::pair<ceres::LinearSolverType, const char *> solvers[] = {{ceres::DENSE_QR, "QR"}, {ceres::DENSE_NORMAL_CHOLESKY, "CHOLESKY"}};
+  for (const auto &[solver, name] : solvers)
+  {
+    double baseline{};
+    for (const std::size_t threads : thread_counts)
+    {
+      double a[N], alpha[N], d[N], theta[N];
+      std::copy_n(nominal_a, N, a);
+      std::copy_n(nominal_alpha, N, alpha);
+      std::copy_n(nominal_d, N, d);
+      std::copy_n(nominal_theta, N, theta);
+
+      kc::CalibrationOptions options;
+      options.num_threads        = int(threads);
+      options.linear_solver_type = solver;
+      options.max_num_iterations = 10;
+      kc::Calibrator<KUKA> calibrator(joint_angles, xyz, a, alpha, d, theta, options);
+
+      const ceres::Solver::Summary summary    = calibrator.solve();
+      const int                    iterations = std::max(1, summary.num_successful_steps + summary.num_unsuccessful_steps);
+      const double                 per_step   = summary.minimizer_time_in_seconds / iterations;
+      if (threads == 1) baseline = per_step;
+      std::cout << std::right << std::setw(8) << threads
+                << std::right << std::setw(12) << name
+                << std::right << std::fixed << std::setprecision(4) << std::setw(15) << per_step
+                << std::right << std::fixed << std::setprecision(2) << std::setw(10) << baseline / per_step
+                << std::right << std::scientific << std::setprecision(6) << std::setw(16) << summary.final_cost << "\n";
+    }
+  }
+  return identical ? EXIT_SUCCESS : EXIT_FAILURE;
+}
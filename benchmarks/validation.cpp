@@ -0,0 +1,83 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "kc/Robot.hpp"
+#include "kc/evaluate.hpp"
+#include "kc/io.hpp"
+#include "kc/parallel.hpp"
+
+#include "synthetic.hpp"
+
+using KUKA  = synthetic::KUKA;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t samples = 1 << 20;
+
+// Compares the per-sample RMSE loop the examples used to end with against kc::evaluate on
+// 1..hardware_concurrency threads, and checks that the statistics do not depend on the number
+// of threads.
+int main(void)
+{
+  const synthetic::Parameters truth;
+
+  kc::Columns<synthetic::N> joint_angles;
+  kc::Columns<3>            xyz;
+  synthetic::generate(truth, samples, joint_angles, xyz);
+
+  const double *const a = synthetic::nominal_a, *const alpha = synthetic::nominal_alpha;
+  const double *const d = synthetic::nominal_d, *const theta = synthetic::nominal_theta;
+
+  const auto serial_start = Clock::now();
+  double     rmse{};
+  for (std::size_t i{}; i < samples; ++i)
+  {
+    const kc::PositionVector error = KUKA::fk(a, alpha, d, theta, joint_angles.row(i)) - xyz.row(i);
+    rmse += error.squaredNorm() / double(samples);
+  }
+  rmse = std::sqrt(rmse);
+  const std::chrono::duration<double> serial = Clock::now() - serial_start;
+
+  std::cout << samples << " synthetic KUKA samples\n";
+  std::cout << std::left << std::setw(16) << "method"
+            << std::right << std::setw(12) << "time [ms]"
+            << std::right << std::setw(10) << "speedup"
+            << std::right << std::setw(14) << "rmse [mm]"
+            << std::right << std::setw(14) << "p99 [mm]"
+            << std::right << std::setw(14) << "identical"
+            << "\n";
+  std::cout << std::left << std::setw(16) << "serial fk"
+            << std::right << std::fixed << std::setprecision(3) << std::setw(12) << serial.count() * 1e3
+            << std::right << std::fixed << std::setprecision(2) << std::setw(10) << 1.
+            << std::right << std::fixed << std::setprecision(6) << std::setw(14) << rmse * 1e3
+            << std::right << std::setw(14) << "-" << std::setw(14) << "-" << "\n";
+
+  kc::Evaluation reference;
+  bool           identical{true};
+  for (std::size_t threads{1}; threads <= kc::default_threads(); threads *= 2)
+  {
+    kc::EvaluationOptions options;
+    options.num_threads = threads;
+
+    const auto                          start      = Clock::now();
+    const kc::Evaluation                evaluation = kc::evaluate<KUKA>(a, alpha, d, theta, joint_angles, xyz, 0, samples, options);
+    const std::chrono::duration<double> elapsed    = Clock::now() - start;
+
+    if (threads == 1) reference = evaluation;
+    const bool same = evaluation.rmse == reference.rmse && evaluation.max == reference.max && evaluation.bias == reference.bias &&
+                      evaluation.p99 == reference.p99 && evaluation.histogram == reference.histogram;
+    identical = identical && same;
+
+    const std::string name = "evaluate x" + std::to_string(threads);
+    std::cout << std::left << std::setw(16) << name
+              << std::right << std::fixed << std::setprecision(3) << std::setw(12) << elapsed.count() * 1e3
+              << std::right << std::fixed << std::setprecision(2) << std::setw(10) << serial.count() / elapsed.count()
+              << std::right << std::fixed << std::setprecision(6) << std::setw(14) << evaluation.rmse * 1e3
+              << std::right << std::fixed << std::setprecision(6) << std::setw(14) << evaluation.p99 * 1e3
+              << std::right << std::setw(14) << (same ? "yes" : "NO") << "\n";
+  }
+  return identical ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,136 @@
+#ifndef KC_BATCHCOSTFUNCTION_HPP_
+#define KC_BATCHCOSTFUNCTION_HPP_
+
+#include <vector>
+
+#include "kc/CostFunction.hpp"
+#include "kc/Robot.hpp"
+#include "kc/io.hpp"
+#include "kc/telemetry.hpp"
+
+#include "ceres/ceres.h"
+
+namespace kc
+{
+  // Residual block covering B consecutive samples. Joint angles and measured positions are stored
+  // as structure-of-arrays (one contiguous column per joint / axis) and the block writes a
+  // 3B x N Jacobian per DH parameter block, i.e. 3B x 4N overall. The sines and cosines of the
+  // joint angles are computed once, at construction (see Robot::JointSinCos).
+  template<class Robot, std::size_t B>
+  struct BatchCostFunction : public ceres::SizedCostFunction<3 * B, Robot::N, Robot::N, Robot::N, Robot::N>
+  {
+    static_assert(B > 0, "Batch size must be positive");
+
+    static constexpr std::size_t BatchSize = B;
+
+    BatchCostFunction(const typename Robot::JointAngles *const x, const PositionVector *const y)
+    {
+      for (std::size_t sample{}; sample < B; ++sample)
+      {
+        this->x_.row(sample) = x[sample].transpose();
+        this->y_.row(sample) = y[sample].transpose();
+      }
+      this->sin_x_ = this->x_.array().sin();
+      this->cos_x_ = this->x_.array().cos();
+    }
+    // Reads the B samples from structure-of-arrays columns, joint j of sample s at
+    // q_soa[j * stride + s] and axis k at xyz_soa[k * stride + s], as laid out by kc::Columns.
+    // The residuals of sample s are scaled by sqrt(weights[s]) when weights is given.
+    BatchCostFunction(const double *const q_soa, const double *const xyz_soa, const std::size_t stride,
+                      const double *const weights = nullptr)
+    {
+      if (weights != nullptr)
+        this->scale_ = Eigen::Map<const Eigen::Vector<double, B>>(weights).cwiseSqrt();
+      for (std::size_t joint{}; joint < Robot::N; ++joint)
+        this->x_.col(joint) = Eigen::Map<const Eigen::Vector<double, B>>(q_soa + joint * stride);
+      for (std::size_t axis{}; axis < 3; ++axis)
+        this->y_.col(axis) = Eigen::Map<const Eigen::Vector<double, B>>(xyz_soa + axis * stride);
+      this->sin_x_ = this->x_.array().sin();
+      this->cos_x_ = this->x_.array().cos();
+    }
+    virtual ~BatchCostFunction() {}
+    virtual bool Evaluate(double const *const *parameters,
+                          double *             residuals,
+                          double **            jacobians) const
+    {
+      KC_TELEMETRY_TIME(Evaluate);
+      const typename Robot::Angles &angles = Robot::cached_angles(parameters[1], parameters[3]);
+      typename Robot::JacobianMatrix jac;
+      typename Robot::JointAngles    q;
+      typename Robot::JointSinCos    joints;
+      for (std::size_t sample{}; sample < B; ++sample)
+      {
+        q                        = this->x_.row(sample).transpose();
+        joints.sin               = this->sin_x_.row(sample).transpose();
+        joints.cos               = this->cos_x_.row(sample).transpose();
+        const PositionVector xyz = (jacobians == nullptr)
+                                       ? Robot::fk(parameters[0], parameters[2], angles, q, joints)
+                                       : Robot::fk_jacobian(parameters[0], parameters[2], angles, q, joints, jac);
+        const double scale        = this->scale_[sample];
+        residuals[3 * sample + 0] = scale * (xyz.x() - this->y_(sample, 0));
+        residuals[3 * sample + 1] = scale * (xyz.y() - this->y_(sample, 1));
+        residuals[3 * sample + 2] = scale * (xyz.z() - this->y_(sample, 2));
+
+        if (jacobians == nullptr) continue;
+
+        for (std::size_t i{}; i < 4; ++i)
+        {
+          if (jacobians[i] == nullptr) continue;
+          std::size_t counter{3 * sample * Robot::N};
+          for (std::size_t row{}; row < 3; ++row)
+            for (std::size_t col{i}; col < Robot::N * 4; col += 4)
+              jacobians[i][counter++] = scale * jac(row, col);
+        }
+      }
+      return true;
+    }
+
+    static auto create(const typename Robot::JointAngles *const x, const PositionVector *const y) -> ceres::CostFunction * { return new BatchCostFunction<Robot, B>(x, y); }
+    static auto create(const double *const q_soa, const double *const xyz_soa, const std::size_t stride, const double *const weights = nullptr) -> ceres::CostFunction *
+    {
+      return new BatchCostFunction<Robot, B>(q_soa, xyz_soa, stride, weights);
+    }
+
+  private:
+    Eigen::Matrix<double, B, Robot::N> x_; // column j holds joint j of every sample
+    Eigen::Matrix<double, B, Robot::N> sin_x_, cos_x_;
+    Eigen::Matrix<double, B, 3>        y_; // columns hold x, y and z of every sample
+    Eigen::Vector<double, B>           scale_{Eigen::Vector<double, B>::Ones()}; // sqrt of the sample weights
+  };
+
+  // Adds samples [begin, end) to the problem in blocks of B; the remainder that does not fill a
+  // whole batch is added one sample per residual block.
+  template<class Robot, std::size_t B>
+  void add_batched_residuals(ceres::Problem &problem,
+                             const std::vector<typename Robot::JointAngles> &joint_angles,
+                             const std::vector<PositionVector>              &xyz,
+                             const std::size_t begin, const std::size_t end,
+                             double *a, double *alpha, double *d, double *theta)
+  {
+    std::size_t i{begin};
+    for (; i + B <= end; i += B)
+      problem.AddResidualBlock(BatchCostFunction<Robot, B>::create(&joint_angles[i], &xyz[i]), nullptr, a, alpha, d, theta);
+    for (; i < end; ++i)
+      problem.AddResidualBlock(CostFunction<Robot>::create(joint_angles[i], xyz[i]), nullptr, a, alpha, d, theta);
+  }
+
+  // Same as above, reading the samples straight from structure-of-arrays columns (kc::Columns
+  // or kc::Dataset); joint_angles and xyz must hold the same number of rows. weights, if given,
+  // holds one weight per row of the columns.
+  template<class Robot, std::size_t B>
+  void add_batched_residuals(ceres::Problem &problem,
+                             const ColumnsView<Robot::N> &joint_angles,
+                             const ColumnsView<3>        &xyz,
+                             const std::size_t begin, const std::size_t end,
+                             double *a, double *alpha, double *d, double *theta,
+                             const double *const weights = nullptr)
+  {
+    std::size_t i{begin};
+    for (; i + B <= end; i += B)
+      problem.AddResidualBlock(BatchCostFunction<Robot, B>::create(joint_angles.data() + i, xyz.data() + i, xyz.rows(), weights != nullptr ? weights + i : nullptr),
+                               nullptr, a, alpha, d, theta);
+    for (; i < end; ++i)
+      problem.AddResidualBlock(CostFunction<Robot>::create(joint_angles.row(i), xyz.row(i), weights != nullptr ? weights[i] : 1.), nullptr, a, alpha, d, theta);
+  }
+} // namespace kc
+#endif // KC_BATCHCOSTFUNCTION_HPP_
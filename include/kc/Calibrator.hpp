@@ -0,0 +1,154 @@
+#ifndef KC_CALIBRATOR_HPP_
+#define KC_CALIBRATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <ostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "kc/BatchCostFunction.hpp"
+#include "kc/CostFunction.hpp"
+#include "kc/TelemetryCallback.hpp"
+#include "kc/identifiability.hpp"
+#include "kc/io.hpp"
+
+#include "ceres/ceres.h"
+
+namespace kc
+{
+  // How the residual blocks evaluate the analytic Jacobian: one kc::CostFunction per sample or
+  // one kc::BatchCostFunction per B consecutive samples.
+  enum class JacobianEvaluation
+  {
+    PerSample,
+    Batched
+  };
+
+  struct CalibrationOptions
+  {
+    int                     num_threads{std::max(1, int(std::thread::hardware_concurrency()))};
+    ceres::LinearSolverType linear_solver_type{ceres::DENSE_QR};
+    JacobianEvaluation      jacobian_evaluation{JacobianEvaluation::Batched};
+    double                  training_fraction{0.8}; // leading fraction of the samples used for the fit
+    int                     max_num_iterations{50};
+    bool                    minimizer_progress_to_stdout{false};
+    bool                    bounded{true}; // a, alpha, d, theta >= 0 and alpha, theta <= 2 pi
+    bool                    fix_unidentifiable{true}; // hold constant the parameters kc::identifiability marks fixed; false: all free, as before
+    IdentifiabilityOptions  identifiability{};
+    std::ostream           *telemetry{nullptr}; // one JSON line per iteration (see kc::TelemetryCallback)
+  };
+
+  // Holds the parameters that kc::identifiability found fixed constant in problem: whole blocks
+  // through SetParameterBlockConstant, single parameters through a ceres::SubsetManifold, so that
+  // the solver only works on the identifiable ones.
+  inline void hold_unidentifiable(ceres::Problem &problem, const Identifiability &identifiability,
+                                  double *a, double *alpha, double *d, double *theta)
+  {
+    const int                     N      = int(identifiability.parameters / 4);
+    const std::array<double *, 4> blocks = {a, alpha, d, theta};
+    for (std::size_t block{}; block < 4; ++block)
+    {
+      const std::vector<int> &fixed = identifiability.fixed[block];
+      if (fixed.empty()) continue;
+      if (int(fixed.size()) == N)
+        problem.SetParameterBlockConstant(blocks[block]);
+      else
+        problem.SetManifold(blocks[block], new ceres::SubsetManifold(N, fixed));
+    }
+  }
+
+  // Builds the calibration problem of Robot over the training split of a dataset, with the DH
+  // parameter blocks a, alpha, d and theta, and solves it in place. problem() stays accessible
+  // between construction and solve for further customisation (e.g. constant blocks).
+  template<class Robot, std::size_t B = 64>
+  struct Calibrator
+  {
+    // Trains on the leading options.training_fraction of the samples
+    Calibrator(const ColumnsView<Robot::N> &joint_angles, const ColumnsView<3> &xyz,
+               double *a, double *alpha, double *d, double *theta,
+               const CalibrationOptions &options = {})
+        : Calibrator(joint_angles, xyz, {{0, std::min(xyz.rows(), std::size_t(double(xyz.rows()) * options.training_fraction))}},
+                     a, alpha, d, theta, options)
+    {
+    }
+
+    // Trains on the given sample ranges, e.g. every fold but one in cross-validation. weights, if
+    // given, holds one weight per sample of the dataset (see kc::robust_weights). Unless disabled,
+    // the DH parameters that the training poses cannot identify at the initial guess are held
+    // constant (see kc::identifiability).
+    Calibrator(const ColumnsView<Robot::N> &joint_angles, const ColumnsView<3> &xyz,
+               const std::vector<SampleRange> &training,
+               double *a, double *alpha, double *d, double *theta,
+               const CalibrationOptions &options = {}, const double *const weights = nullptr)
+        : joint_angles_{joint_angles}, xyz_{xyz}, options_{options}
+    {
+      for (const auto &[begin, end] : training)
+      {
+        this->training_ += end - begin;
+        if (options.jacobian_evaluation == JacobianEvaluation::Batched)
+          add_batched_residuals<Robot, B>(this->problem_, joint_angles, xyz, begin, end, a, alpha, d, theta, weights);
+        else
+          for (std::size_t i{begin}; i < end; ++i)
+            this->problem_.AddResidualBlock(CostFunction<Robot>::create(joint_angles.row(i), xyz.row(i), weights != nullptr ? weights[i] : 1.),
+                                            nullptr, a, alpha, d, theta);
+      }
+
+      if (options.telemetry != nullptr)
+        this->telemetry_ = std::make_unique<TelemetryCallback>(*options.telemetry);
+
+      if (options.fix_unidentifiable)
+      {
+        this->identifiability_ = kc::identifiability<Robot>(a, alpha, d, theta, joint_angles, training, options.identifiability);
+        hold_unidentifiable(this->problem_, this->identifiability_, a, alpha, d, theta);
+      }
+
+      if (!options.bounded) return;
+      for (std::size_t i{}; i < Robot::N; ++i)
+      {
+        this->problem_.SetParameterLowerBound(a, i, 0.);
+        this->problem_.SetParameterLowerBound(alpha, i, 0.);
+        this->problem_.SetParameterLowerBound(d, i, 0.);
+        this->problem_.SetParameterLowerBound(theta, i, 0.);
+        this->problem_.SetParameterUpperBound(alpha, i, 2.0 * ceres::constants::pi);
+        this->problem_.SetParameterUpperBound(theta, i, 2.0 * ceres::constants::pi);
+      }
+    }
+
+    [[nodiscard]] auto problem() -> ceres::Problem & { return this->problem_; }
+    [[nodiscard]] auto training_samples() const -> std::size_t { return this->training_; }
+    [[nodiscard]] auto validation_samples() const -> std::size_t { return this->xyz_.rows() - this->training_; }
+    [[nodiscard]] auto identifiability() const -> const Identifiability & { return this->identifiability_; }
+
+    [[nodiscard]] auto solver_options() const -> ceres::Solver::Options
+    {
+      ceres::Solver::Options options;
+      options.num_threads                  = this->options_.num_threads;
+      options.linear_solver_type           = this->options_.linear_solver_type;
+      options.max_num_iterations           = this->options_.max_num_iterations;
+      options.minimizer_progress_to_stdout = this->options_.minimizer_progress_to_stdout;
+      if (this->telemetry_) options.callbacks.push_back(this->telemetry_.get());
+      return options;
+    }
+
+    auto solve() -> ceres::Solver::Summary
+    {
+      ceres::Solver::Summary summary;
+      ceres::Solve(this->solver_options(), &this->problem_, &summary);
+      return summary;
+    }
+
+  private:
+    ColumnsView<Robot::N>              joint_angles_;
+    ColumnsView<3>                     xyz_;
+    CalibrationOptions                 options_;
+    std::size_t                        training_{};
+    Identifiability                    identifiability_;
+    std::unique_ptr<TelemetryCallback> telemetry_;
+    ceres::Problem                     problem_;
+  };
+} // namespace kc
+
+#endif // KC_CALIBRATOR_HPP_
@@ -1,45 +1,58 @@
 #ifndef KC_COSTFUNCTION_HPP_
 #define KC_COSTFUNCTION_HPP_
 
+#include <cmath>
+
 #include "kc/Robot.hpp"
+#include "kc/telemetry.hpp"
 
 #include "ceres/ceres.h"
 
 namespace kc
 {
+  // Position residual of one sample, scaled by sqrt(weight) (see kc::robust_weights). The sines and
+  // cosines of the joint angles are computed once, at construction, and those of the DH angles
+  // are shared through Robot::cached_angles.
   template<class Robot>
   struct CostFunction : public ceres::SizedCostFunction<3, Robot::N, Robot::N, Robot::N, Robot::N>
   {
-    CostFunction(const typename Robot::JointAngles &x, const PositionVector &y) : x_{x}, y_{y} {}
+    CostFunction(const typename Robot::JointAngles &x, const PositionVector &y, const double weight = 1.)
+        : x_{x}, joints_{Robot::joint_sincos(x)}, y_{y}, scale_{std::sqrt(weight)} {}
     virtual ~CostFunction() {}
     virtual bool Evaluate(double const *const *parameters,
                           double *             residuals,
                           double **            jacobians) const
     {
-      PositionVector xyz = Robot::fk(parameters[0], parameters[1], parameters[2], parameters[3], this->x_);
-      residuals[0]       = xyz.x() - this->y_.x();
-      residuals[1]       = xyz.y() - this->y_.y();
-      residuals[2]       = xyz.z() - this->y_.z();
+      KC_TELEMETRY_TIME(Evaluate);
+      const typename Robot::Angles  &angles = Robot::cached_angles(parameters[1], parameters[3]);
+      typename Robot::JacobianMatrix jac;
+      const PositionVector           xyz = (jacobians == nullptr)
+                                               ? Robot::fk(parameters[0], parameters[2], angles, this->x_, this->joints_)
+                                               : Robot::fk_jacobian(parameters[0], parameters[2], angles, this->x_, this->joints_, jac);
+      residuals[0] = this->scale_ * (xyz.x() - this->y_.x());
+      residuals[1] = this->scale_ * (xyz.y() - this->y_.y());
+      residuals[2] = this->scale_ * (xyz.z() - this->y_.z());
 
       if (jacobians == nullptr) return true;
 
-      typename Robot::JacobianMatrix jac = Robot::jacobian(parameters[0], parameters[1], parameters[2], parameters[3], this->x_);
       for (std::size_t i{}; i < 4; ++i)
       {
         std::size_t counter{};
         if (jacobians[i] != nullptr)
           for (std::size_t row{}; row < 3; ++row)
             for (std::size_t col{i}; col < Robot::N * 4; col += 4)
-              jacobians[i][counter++] = jac(row, col);
+              jacobians[i][counter++] = this->scale_ * jac(row, col);
       }
       return true;
     }
 
-    static auto create(const typename Robot::JointAngles &x, const PositionVector &y) -> ceres::CostFunction * { return new CostFunction<Robot>(x, y); }
+    static auto create(const typename Robot::JointAngles &x, const PositionVector &y, const double weight = 1.) -> ceres::CostFunction * { return new CostFunction<Robot>(x, y, weight); }
 
   private:
     typename Robot::JointAngles x_;
+    typename Robot::JointSinCos joints_; // sin and cos of x_, fixed for the block
     PositionVector              y_;
+    double                      scale_;
   };
 } // namespace kc
 #endif
\ No newline at end of file
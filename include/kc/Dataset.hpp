@@ -0,0 +1,153 @@
+#ifndef KC_DATASET_HPP_
+#define KC_DATASET_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "kc/io.hpp"
+
+#include "Eigen/Dense"
+
+namespace kc
+{
+  // Binary calibration dataset: joint angles and measured positions of the same samples in a
+  // single file, stored in native (little-endian) byte order as
+  //
+  //   DatasetHeader | padding | q_0 ... q_{N-1} | x | y | z
+  //
+  // The columns lie back to back from a 64-byte aligned payload, so the joint angles and the
+  // positions each form a ColumnsView with stride samples. checksum is kc::detail::checksum of the
+  // payload.
+  struct DatasetHeader
+  {
+    static constexpr char          Magic[8] = {'K', 'C', 'D', 'A', 'T', 'A', '\0', '\0'};
+    static constexpr std::uint32_t Version  = 2; // 1 also stored a table of column offsets
+
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t joints;
+    std::uint64_t samples;
+    std::uint64_t checksum;
+  };
+
+  namespace detail
+  {
+    // FNV-1a over 64-bit words, cheap enough to verify a mapped dataset at memory bandwidth.
+    [[nodiscard]] inline auto checksum(const double *const data, const std::size_t count) -> std::uint64_t
+    {
+      std::uint64_t hash{14695981039346656037ULL};
+      for (std::size_t i{}; i < count; ++i)
+      {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ULL;
+      }
+      return hash;
+    }
+
+    [[nodiscard]] constexpr auto payload_offset() -> std::size_t
+    {
+      return (sizeof(DatasetHeader) + 63) / 64 * 64;
+    }
+  } // namespace detail
+
+  // Writes samples rows of joint angles (joints columns) and positions (3 columns), both in
+  // structure-of-arrays layout, as a binary dataset.
+  [[nodiscard]] inline auto write_dataset(const std::string &filename, const std::size_t joints, const std::size_t samples,
+                                          const double *const q_soa, const double *const xyz_soa) -> LoadStatus
+  {
+    const std::size_t payload = detail::payload_offset();
+
+    std::vector<double> columns(q_soa, q_soa + joints * samples);
+    columns.insert(columns.end(), xyz_soa, xyz_soa + 3 * samples);
+
+    DatasetHeader header{};
+    std::memcpy(header.magic, DatasetHeader::Magic, sizeof(header.magic));
+    header.version  = DatasetHeader::Version;
+    header.joints   = static_cast<std::uint32_t>(joints);
+    header.samples  = samples;
+    header.checksum = detail::checksum(columns.data(), columns.size());
+
+    const std::vector<char> padding(payload - sizeof(header), 0);
+
+    std::FILE *file = std::fopen(filename.c_str(), "wb");
+    if (file == nullptr) return {LoadError::Open, 0, "Could not open file " + filename + " for writing"};
+    const bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                         std::fwrite(padding.data(), 1, padding.size(), file) == padding.size() &&
+                         std::fwrite(columns.data(), sizeof(double), columns.size(), file) == columns.size();
+    if (std::fclose(file) != 0 || !written) return {LoadError::Write, 0, "Could not write " + filename};
+    return {};
+  }
+
+  template<std::size_t N>
+  [[nodiscard]] auto write_dataset(const std::string &filename, const ColumnsView<N> &joint_angles, const ColumnsView<3> &xyz) -> LoadStatus
+  {
+    if (joint_angles.rows() != xyz.rows())
+      return {LoadError::Mismatch, 0, filename + ": " + std::to_string(joint_angles.rows()) + " joint samples but " + std::to_string(xyz.rows()) + " positions"};
+    return write_dataset(filename, N, xyz.rows(), joint_angles.data(), xyz.data());
+  }
+
+  // Converts a pair of text files (e.g. data/Q_Stanford.txt and data/P_Stanford.txt) to a
+  // binary dataset.
+  template<std::size_t N>
+  [[nodiscard]] auto convert_dataset(const std::string &q_filename, const std::string &xyz_filename,
+                                     const std::string &filename) -> LoadStatus
+  {
+    Columns<N> joint_angles;
+    Columns<3> xyz;
+    if (LoadStatus status = load_samples(q_filename, xyz_filename, joint_angles, xyz); !status) return status;
+    return write_dataset<N>(filename, joint_angles, xyz);
+  }
+
+  // Memory-mapped binary dataset of an N-joint robot. open validates the header and, unless
+  // told otherwise, the checksum; the columns are then read in place without any parsing.
+  template<std::size_t N>
+  struct Dataset
+  {
+    [[nodiscard]] auto open(const std::string &filename, const bool verify = true) -> LoadStatus
+    {
+      this->file_    = std::make_unique<detail::MappedFile>();
+      this->samples_ = 0;
+      if (LoadStatus status = this->file_->open(filename); !status) return status;
+
+      const std::size_t payload = detail::payload_offset();
+      if (this->file_->size < payload) return {LoadError::Format, 0, filename + " is not a kc dataset"};
+
+      DatasetHeader header;
+      std::memcpy(&header, this->file_->data, sizeof(header));
+      if (std::memcmp(header.magic, DatasetHeader::Magic, sizeof(header.magic)) != 0 || header.version != DatasetHeader::Version)
+        return {LoadError::Format, 0, filename + " is not a version " + std::to_string(DatasetHeader::Version) + " kc dataset"};
+      if (header.joints != N)
+        return {LoadError::Format, 0, filename + " holds " + std::to_string(header.joints) + " joints, expected " + std::to_string(N)};
+      // samples comes from the file: bound it by the mapped size before multiplying, so that a
+      // crafted count cannot wrap the expected size around and pass
+      constexpr std::size_t row    = (N + 3) * sizeof(double);
+      const std::size_t     stored = this->file_->size - payload;
+      if (header.samples > stored / row || header.samples * row != stored)
+        return {LoadError::Format, 0, filename + " is truncated or holds " + std::to_string(stored) + " bytes for " + std::to_string(header.samples) + " samples"};
+
+      const double *const columns = reinterpret_cast<const double *>(this->file_->data + payload);
+      if (verify && detail::checksum(columns, (N + 3) * header.samples) != header.checksum)
+        return {LoadError::Checksum, 0, filename + ": checksum mismatch"};
+
+      this->columns_ = columns;
+      this->samples_ = header.samples;
+      return {};
+    }
+
+    [[nodiscard]] auto samples() const -> std::size_t { return this->samples_; }
+    [[nodiscard]] auto joint_angles() const -> ColumnsView<N> { return {this->columns_, this->samples_}; }
+    [[nodiscard]] auto xyz() const -> ColumnsView<3> { return {this->columns_ + N * this->samples_, this->samples_}; }
+
+  private:
+    std::unique_ptr<detail::MappedFile> file_;
+    const double                       *columns_{};
+    std::size_t                         samples_{};
+  };
+} // namespace kc
+
+#endif // KC_DATASET_HPP_
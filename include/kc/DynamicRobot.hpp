@@ -0,0 +1,341 @@
+#ifndef KC_DYNAMICROBOT_HPP_
+#define KC_DYNAMICROBOT_HPP_
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "kc/BatchCostFunction.hpp"
+#include "kc/Link.hpp"
+#include "kc/Robot.hpp"
+#include "kc/robots.hpp"
+#include "kc/simd.hpp"
+#include "kc/telemetry.hpp"
+#include "kc/types.hpp"
+
+#include "Eigen/Dense"
+#include "ceres/ceres.h"
+
+namespace kc
+{
+  // Parses a joint sequence such as "RRPRRR" into link types; false on any other character
+  [[nodiscard]] inline auto parse_links(const std::string &shape, std::vector<LinkType> &links) -> bool
+  {
+    links.clear();
+    for (const char c : shape)
+    {
+      if (c != 'R' && c != 'P') return false;
+      links.push_back(c == 'R' ? LinkType::Revolute : LinkType::Prismatic);
+    }
+    return !links.empty();
+  }
+
+  // Serial chain whose links are only known at run time, with the kinematics API of
+  // Robot<Links...> (a, alpha, d, theta hold size() values each). Chains matching one of
+  // kc::robots are routed to the kernels of that static instantiation; any other chain goes
+  // through a loop over the links. The hot paths take a Workspace so that nothing is allocated
+  // per sample.
+  struct DynamicRobot
+  {
+    using JointAngles    = Eigen::VectorXd;
+    using JacobianMatrix = Eigen::Matrix<double, 3, Eigen::Dynamic>;
+
+    // Scratch buffers of fk_jacobian and fk_batch, sized once for a robot (see workspace())
+    struct Workspace
+    {
+      std::vector<TransformationMatrix> transforms, prefix;
+      std::vector<HomogeneousVector>    suffix;
+      std::vector<double>               sin_alpha, cos_alpha;
+    };
+
+    // dispatch = false keeps the generic path even for chains of kc::robots (e.g. to compare them).
+    // Throws std::invalid_argument for a chain without links.
+    explicit DynamicRobot(std::vector<LinkType> links, const bool dispatch = true) : links_{std::move(links)}
+    {
+      if (this->links_.empty()) throw std::invalid_argument{"kc::DynamicRobot: the chain has no links"};
+      if (dispatch)
+        robots::visit(this->shape(), [this](auto tag) {
+          using Static        = typename decltype(tag)::type;
+          this->static_fk_    = &static_fk<Static>;
+          this->static_jac_   = &static_fk_jacobian<Static>;
+          this->static_batch_ = &static_fk_batch<Static>;
+        });
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return this->links_.size(); }
+    [[nodiscard]] auto links() const -> const std::vector<LinkType> & { return this->links_; }
+    [[nodiscard]] auto is_static() const -> bool { return this->static_fk_ != nullptr; }
+
+    [[nodiscard]] auto shape() const -> std::string
+    {
+      std::string out;
+      for (const LinkType link : this->links_)
+        out += link == LinkType::Revolute ? 'R' : 'P';
+      return out;
+    }
+
+    [[nodiscard]] auto workspace() const -> Workspace
+    {
+      const std::size_t N = this->size();
+      return {std::vector<TransformationMatrix>(N), std::vector<TransformationMatrix>(N + 1),
+              std::vector<HomogeneousVector>(N), std::vector<double>(N), std::vector<double>(N)};
+    }
+
+    [[nodiscard]] auto fk(const double *const a, const double *const alpha,
+                          const double *const d, const double *const theta,
+                          const Eigen::Ref<const JointAngles> &q) const -> PositionVector
+    {
+      if (this->is_static()) return this->static_fk_(a, alpha, d, theta, q.data());
+
+      TransformationMatrix out = TransformationMatrix::Identity();
+      for (std::size_t link{}; link < this->size(); ++link)
+        out = out * this->transform(link, a[link], alpha[link], d[link], theta[link], q[link]);
+      return out.block(0, 3, 3, 1);
+    }
+
+    [[nodiscard]] auto jacobian(const double *const a, const double *const alpha,
+                                const double *const d, const double *const theta,
+                                const Eigen::Ref<const JointAngles> &q) const -> JacobianMatrix
+    {
+      JacobianMatrix out(3, 4 * this->size());
+      Workspace      workspace = this->workspace();
+      this->fk_jacobian(a, alpha, d, theta, q, out, workspace);
+      return out;
+    }
+
+    // Forward kinematics and the 3 x 4N Jacobian, laid out as in Robot::fk_jacobian. jacobian is
+    // resized to 3 x 4N if needed.
+    auto fk_jacobian(const double *const a, const double *const alpha,
+                     const double *const d, const double *const theta,
+                     const Eigen::Ref<const JointAngles> &q, JacobianMatrix &jacobian, Workspace &workspace) const -> PositionVector
+    {
+      const std::size_t N = this->size();
+      jacobian.resize(3, Eigen::Index(4 * N));
+      if (this->is_static()) return this->static_jac_(a, alpha, d, theta, q.data(), jacobian.data());
+
+      for (std::size_t link{}; link < N; ++link)
+        workspace.transforms[link] = this->transform(link, a[link], alpha[link], d[link], theta[link], q[link]);
+
+      workspace.prefix[0] = TransformationMatrix::Identity();
+      for (std::size_t link{}; link < N; ++link)
+        workspace.prefix[link + 1] = workspace.prefix[link] * workspace.transforms[link];
+
+      workspace.suffix[N - 1] = HomogeneousVector::UnitW();
+      for (std::size_t link{N - 1}; link > 0; --link)
+        workspace.suffix[link - 1] = workspace.transforms[link] * workspace.suffix[link];
+
+      for (std::size_t link{}; link < N; ++link)
+        jacobian.block<3, 4>(0, Eigen::Index(4 * link)) = with_link(link, [&](auto type) {
+          return decltype(type)::jacobian(a[link], alpha[link], d[link], theta[link], q[link], workspace.prefix[link], workspace.suffix[link]);
+        });
+      return workspace.prefix[N].block(0, 3, 3, 1);
+    }
+
+    // See Robot::fk_batch
+    void fk_batch(const double *const a, const double *const alpha,
+                  const double *const d, const double *const theta,
+                  const double *const q_soa, const std::size_t count, double *const xyz_out) const
+    {
+      Workspace workspace = this->workspace();
+      this->fk_batch(a, alpha, d, theta, q_soa, count, count, xyz_out, count, workspace);
+    }
+
+    void fk_batch(const double *const a, const double *const alpha,
+                  const double *const d, const double *const theta,
+                  const double *const q_soa, const std::size_t q_stride, const std::size_t count,
+                  double *const xyz_out, const std::size_t xyz_stride, Workspace &workspace) const
+    {
+      if (this->is_static())
+      {
+        this->static_batch_(a, alpha, d, theta, q_soa, q_stride, count, xyz_out, xyz_stride);
+        return;
+      }
+
+      constexpr std::size_t W = simd::width;
+      const std::size_t     N = this->size();
+
+      for (std::size_t link{}; link < N; ++link)
+      {
+        workspace.sin_alpha[link] = std::sin(alpha[link]);
+        workspace.cos_alpha[link] = std::cos(alpha[link]);
+      }
+
+      std::size_t sample{};
+      for (; sample + W <= count; sample += W)
+      {
+        alignas(64) double m[3][4][W];
+        for (std::size_t row{}; row < 3; ++row)
+          for (std::size_t col{}; col < 4; ++col)
+            for (std::size_t lane{}; lane < W; ++lane)
+              m[row][col][lane] = (row == col) ? 1.0 : 0.0;
+
+        for (std::size_t link{}; link < N; ++link)
+          with_link(link, [&](auto type) {
+            decltype(type)::template transform_lanes<W>(a[link], workspace.sin_alpha[link], workspace.cos_alpha[link], d[link], theta[link],
+                                                        q_soa + link * q_stride + sample, m);
+          });
+
+        for (std::size_t row{}; row < 3; ++row)
+          for (std::size_t lane{}; lane < W; ++lane)
+            xyz_out[row * xyz_stride + sample + lane] = m[row][3][lane];
+      }
+
+      for (; sample < count; ++sample)
+      {
+        TransformationMatrix out = TransformationMatrix::Identity();
+        for (std::size_t link{}; link < N; ++link)
+          out = out * this->transform(link, a[link], alpha[link], d[link], theta[link], q_soa[link * q_stride + sample]);
+        for (std::size_t row{}; row < 3; ++row)
+          xyz_out[row * xyz_stride + sample] = out(Eigen::Index(row), 3);
+      }
+    }
+
+  private:
+    template<class F>
+    auto with_link(const std::size_t link, F &&f) const -> decltype(f(LR{}))
+    {
+      return this->links_[link] == LinkType::Revolute ? f(LR{}) : f(LP{});
+    }
+
+    [[nodiscard]] auto transform(const std::size_t link, const double a, const double alpha,
+                                 const double d, const double theta, const double q) const -> TransformationMatrix
+    {
+      return with_link(link, [&](auto type) { return decltype(type)::transform(a, alpha, d, theta, q); });
+    }
+
+    template<class Robot>
+    static auto static_fk(const double *a, const double *alpha, const double *d, const double *theta, const double *q) -> PositionVector
+    {
+      return Robot::fk(a, alpha, d, theta, typename Robot::JointAngles(q));
+    }
+
+    template<class Robot>
+    static auto static_fk_jacobian(const double *a, const double *alpha, const double *d, const double *theta,
+                                   const double *q, double *jacobian) -> PositionVector
+    {
+      typename Robot::JacobianMatrix out;
+      const PositionVector           xyz = Robot::fk_jacobian(a, alpha, d, theta, typename Robot::JointAngles(q), out);
+      Eigen::Map<typename Robot::JacobianMatrix>{jacobian} = out;
+      return xyz;
+    }
+
+    template<class Robot>
+    static void static_fk_batch(const double *a, const double *alpha, const double *d, const double *theta,
+                                const double *q_soa, std::size_t q_stride, std::size_t count, double *xyz_out, std::size_t xyz_stride)
+    {
+      Robot::fk_batch(a, alpha, d, theta, q_soa, q_stride, count, xyz_out, xyz_stride);
+    }
+
+    using FkKernel         = PositionVector (*)(const double *, const double *, const double *, const double *, const double *);
+    using FkJacobianKernel = PositionVector (*)(const double *, const double *, const double *, const double *, const double *, double *);
+    using FkBatchKernel    = void (*)(const double *, const double *, const double *, const double *,
+                                   const double *, std::size_t, std::size_t, double *, std::size_t);
+
+    std::vector<LinkType> links_;
+    FkKernel              static_fk_{};
+    FkJacobianKernel      static_jac_{};
+    FkBatchKernel         static_batch_{};
+  };
+
+  // Position residual of one sample of a DynamicRobot, over the parameter blocks a, alpha, d and
+  // theta of robot.size() values each. The Jacobian is evaluated into scratch buffers of the
+  // calling thread, as the static path keeps its own on the stack, so an instance holds no mutable
+  // state and may be shared between residual blocks and evaluated concurrently.
+  struct DynamicCostFunction : public ceres::DynamicCostFunction
+  {
+    DynamicCostFunction(const DynamicRobot &robot, const Eigen::Ref<const DynamicRobot::JointAngles> &x, const PositionVector &y)
+        : robot_{robot}, x_{x}, y_{y}
+    {
+      for (std::size_t block{}; block < 4; ++block)
+        this->AddParameterBlock(int(robot.size()));
+      this->SetNumResiduals(3);
+      scratch(robot); // sized up front for the constructing thread
+    }
+
+    virtual bool Evaluate(double const *const *parameters,
+                          double *             residuals,
+                          double **            jacobians) const
+    {
+      KC_TELEMETRY_TIME(Evaluate);
+      Scratch             &buffers = scratch(this->robot_);
+      const PositionVector xyz     = (jacobians == nullptr)
+                                         ? this->robot_.fk(parameters[0], parameters[1], parameters[2], parameters[3], this->x_)
+                                         : this->robot_.fk_jacobian(parameters[0], parameters[1], parameters[2], parameters[3], this->x_,
+                                                                    buffers.jacobian, buffers.workspace);
+      residuals[0] = xyz.x() - this->y_.x();
+      residuals[1] = xyz.y() - this->y_.y();
+      residuals[2] = xyz.z() - this->y_.z();
+
+      if (jacobians == nullptr) return true;
+
+      const std::size_t N = this->robot_.size();
+      for (std::size_t i{}; i < 4; ++i)
+      {
+        std::size_t counter{};
+        if (jacobians[i] != nullptr)
+          for (std::size_t row{}; row < 3; ++row)
+            for (std::size_t col{i}; col < N * 4; col += 4)
+              jacobians[i][counter++] = buffers.jacobian(Eigen::Index(row), Eigen::Index(col));
+      }
+      return true;
+    }
+
+    static auto create(const DynamicRobot &robot, const Eigen::Ref<const DynamicRobot::JointAngles> &x, const PositionVector &y) -> ceres::CostFunction *
+    {
+      return new DynamicCostFunction(robot, x, y);
+    }
+
+  private:
+    struct Scratch
+    {
+      DynamicRobot::JacobianMatrix jacobian;
+      DynamicRobot::Workspace      workspace;
+    };
+
+    // Buffers of the calling thread, grown to the longest chain it has evaluated: once they fit,
+    // Evaluate allocates nothing (the Jacobian is only reallocated when chains of different
+    // lengths alternate on the same thread).
+    static auto scratch(const DynamicRobot &robot) -> Scratch &
+    {
+      thread_local Scratch buffers;
+      if (buffers.workspace.suffix.size() < robot.size()) buffers.workspace = robot.workspace();
+      buffers.jacobian.resize(3, Eigen::Index(4 * robot.size()));
+      return buffers;
+    }
+
+    DynamicRobot              robot_;
+    DynamicRobot::JointAngles x_;
+    PositionVector            y_;
+  };
+
+  // Adds the residuals of samples [begin, end) to problem. q_soa holds robot.size() columns and
+  // xyz_soa 3 columns of rows samples each (see kc::ColumnsView). Chains matching one of
+  // kc::robots use kc::add_batched_residuals of the static instantiation, any other chain one
+  // DynamicCostFunction per sample. Returns whether the static path was taken.
+  template<std::size_t B = 64>
+  auto add_residuals(ceres::Problem &problem, const DynamicRobot &robot,
+                     const double *const q_soa, const double *const xyz_soa, const std::size_t rows,
+                     const std::size_t begin, const std::size_t end,
+                     double *a, double *alpha, double *d, double *theta) -> bool
+  {
+    const bool found = robots::visit(robot.shape(), [&](auto tag) {
+      using Robot = typename decltype(tag)::type;
+      add_batched_residuals<Robot, B>(problem, ColumnsView<Robot::N>{q_soa, rows}, ColumnsView<3>{xyz_soa, rows}, begin, end, a, alpha, d, theta);
+    });
+    if (found) return true;
+
+    DynamicRobot::JointAngles q(robot.size());
+    for (std::size_t i{begin}; i < end; ++i)
+    {
+      for (std::size_t joint{}; joint < robot.size(); ++joint)
+        q[Eigen::Index(joint)] = q_soa[joint * rows + i];
+      const PositionVector y{xyz_soa[i], xyz_soa[rows + i], xyz_soa[2 * rows + i]};
+      problem.AddResidualBlock(DynamicCostFunction::create(robot, q, y), nullptr, a, alpha, d, theta);
+    }
+    return false;
+  }
+} // namespace kc
+
+#endif // KC_DYNAMICROBOT_HPP_
@@ -0,0 +1,397 @@
+#ifndef KC_FLEET_HPP_
+#define KC_FLEET_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "kc/Calibrator.hpp"
+#include "kc/Dataset.hpp"
+#include "kc/ThreadPool.hpp"
+#include "kc/evaluate.hpp"
+#include "kc/io.hpp"
+#include "kc/parallel.hpp"
+#include "kc/robots.hpp"
+
+#include "ceres/ceres.h"
+
+namespace kc
+{
+  // One arm of the fleet: its kinematic template, its samples (a binary dataset or a joint angle /
+  // position text pair) and the initial DH parameters the solve starts from.
+  struct FleetJob
+  {
+    std::string              name;
+    std::string              robot; // model or joint sequence, see kc::robots::visit
+    std::string              dataset;
+    std::string              joint_angles, positions;
+    std::vector<double>      a, alpha, d, theta;
+    std::vector<std::string> constant; // parameter blocks held constant ("a", "alpha", "d", "theta")
+    double                   training_fraction{0.8};
+    int                      max_num_iterations{50};
+    std::size_t              bytes{}; // size of the sample files, a proxy for the cost of the job
+  };
+
+  struct FleetOptions
+  {
+    std::size_t num_threads{default_threads()};
+    std::size_t concurrent_jobs{}; // 0: one per thread, at most one per job
+  };
+
+  struct FleetResult
+  {
+    std::string            name, robot;
+    LoadStatus             status;
+    std::size_t            threads{};
+    std::size_t            samples{}, training{};
+    double                 load_seconds{}, solve_seconds{};
+    ceres::Solver::Summary summary;
+    Evaluation             validation;
+    std::vector<double>    parameters; // a, alpha, d, theta back to back
+  };
+
+  struct FleetSummary
+  {
+    std::size_t jobs{}, failed{};
+    double      seconds{};
+  };
+
+  namespace detail
+  {
+    [[nodiscard]] inline auto trim(const std::string &s) -> std::string
+    {
+      const auto first = s.find_first_not_of(" \t\r");
+      if (first == std::string::npos) return {};
+      return s.substr(first, s.find_last_not_of(" \t\r") - first + 1);
+    }
+
+    [[nodiscard]] inline auto file_bytes(const std::string &filename) -> std::size_t
+    {
+      std::error_code   error;
+      const std::size_t bytes = std::filesystem::file_size(filename, error);
+      return error ? 0 : bytes;
+    }
+
+    [[nodiscard]] inline auto json_string(const std::string &s) -> std::string
+    {
+      std::string out{"\""};
+      for (const char c : s)
+      {
+        if (c == '"' || c == '\\')
+          out += {'\\', c};
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          out += escaped;
+        }
+        else
+          out += c;
+      }
+      return out + "\"";
+    }
+  } // namespace detail
+
+  // Reads a fleet manifest, one section per job:
+  //
+  //   # comment
+  //   [kuka-cell-3]
+  //   robot              = KUKA
+  //   dataset            = kuka-cell-3.kcd            (or joint_angles = Q.txt, positions = P.txt)
+  //   a                  = 0 0 0 0 0 0 0
+  //   alpha              = 4.71 1.57 4.71 1.57 4.71 1.57 0
+  //   d                  = 0.34 0 0.4 0 0.4 0 0.126
+  //   theta              = 0 0 0 0 0 0 0
+  //   constant           = alpha d                    (optional)
+  //   training_fraction  = 0.8                        (optional)
+  //   max_num_iterations = 50                         (optional)
+  //
+  // Relative paths are resolved against the directory of the manifest.
+  [[nodiscard]] inline auto load_manifest(const std::string &filename, std::vector<FleetJob> &jobs) -> LoadStatus
+  {
+    std::ifstream file(filename);
+    if (!file) return {LoadError::Open, 0, "Could not open file " + filename};
+
+    const std::filesystem::path directory = std::filesystem::path(filename).parent_path();
+    const auto                  resolve   = [&](const std::string &path) { return (directory / path).lexically_normal().string(); };
+
+    jobs.clear();
+    std::string line;
+    for (std::size_t row{1}; std::getline(file, line); ++row)
+    {
+      const auto error = [&](const std::string &message) -> LoadStatus { return {LoadError::Parse, row, filename + ":" + std::to_string(row) + ": " + message}; };
+
+      line = detail::trim(line.substr(0, line.find('#')));
+      if (line.empty()) continue;
+      if (line.front() == '[')
+      {
+        if (line.back() != ']') return error("unterminated section name");
+        jobs.emplace_back();
+        jobs.back().name = detail::trim(line.substr(1, line.size() - 2));
+        continue;
+      }
+
+      const auto equals = line.find('=');
+      if (equals == std::string::npos) return error("expected key = value");
+      if (jobs.empty()) return error("key outside of a [job] section");
+
+      FleetJob          &job   = jobs.back();
+      const std::string  key   = detail::trim(line.substr(0, equals));
+      const std::string  value = detail::trim(line.substr(equals + 1));
+      std::istringstream values(value);
+
+      if (key == "robot")
+      {
+        if (!robots::visit(value, [](auto) {})) return error("unknown robot " + value);
+        job.robot = value;
+      }
+      else if (key == "dataset")
+        job.dataset = resolve(value);
+      else if (key == "joint_angles")
+        job.joint_angles = resolve(value);
+      else if (key == "positions")
+        job.positions = resolve(value);
+      else if (key == "a" || key == "alpha" || key == "d" || key == "theta")
+      {
+        std::vector<double> &block = key == "a" ? job.a : key == "alpha" ? job.alpha : key == "d" ? job.d : job.theta;
+        block.clear();
+        for (double x; values >> x;)
+          block.push_back(x);
+        if (!values.eof()) return error("invalid number in " + key);
+      }
+      else if (key == "constant")
+      {
+        for (std::string block; values >> block;)
+        {
+          if (block != "a" && block != "alpha" && block != "d" && block != "theta") return error("unknown parameter block " + block);
+          job.constant.push_back(block);
+        }
+      }
+      else if (key == "training_fraction")
+      {
+        if (!(values >> job.training_fraction) || job.training_fraction <= 0. || job.training_fraction > 1.)
+          return error("training_fraction must be in (0, 1]");
+      }
+      else if (key == "max_num_iterations")
+      {
+        if (!(values >> job.max_num_iterations) || job.max_num_iterations <= 0) return error("max_num_iterations must be positive");
+      }
+      else
+        return error("unknown key " + key);
+    }
+
+    for (FleetJob &job : jobs)
+    {
+      const auto error = [&](const std::string &message) -> LoadStatus { return {LoadError::Format, 0, filename + ": [" + job.name + "] " + message}; };
+      if (job.robot.empty()) return error("no robot");
+      if (job.dataset.empty() == (job.joint_angles.empty() || job.positions.empty()))
+        return error("needs either a dataset or joint_angles and positions");
+      if (job.a.empty() || job.alpha.empty() || job.d.empty() || job.theta.empty()) return error("needs initial a, alpha, d and theta");
+      job.bytes = job.dataset.empty() ? detail::file_bytes(job.joint_angles) + detail::file_bytes(job.positions) : detail::file_bytes(job.dataset);
+    }
+    return {};
+  }
+
+  // Calibrates a single job with the static instantiation Robot on the given number of threads:
+  // loads its samples, solves on the training split and evaluates on the rest.
+  template<class Robot, std::size_t B = 64>
+  [[nodiscard]] auto run_job(const FleetJob &job, const std::size_t threads) -> FleetResult
+  {
+    using Clock             = std::chrono::steady_clock;
+    constexpr std::size_t N = Robot::N;
+
+    FleetResult out;
+    out.name    = job.name;
+    out.robot   = job.robot;
+    out.threads = threads;
+    if (job.a.size() != N || job.alpha.size() != N || job.d.size() != N || job.theta.size() != N)
+    {
+      out.status = {LoadError::Mismatch, 0, job.name + ": " + job.robot + " needs " + std::to_string(N) + " values per DH parameter block"};
+      return out;
+    }
+
+    const auto     load_start = Clock::now();
+    Dataset<N>     dataset;
+    Columns<N>     q;
+    Columns<3>     p;
+    ColumnsView<N> joint_angles;
+    ColumnsView<3> xyz;
+    if (!job.dataset.empty())
+    {
+      out.status   = dataset.open(job.dataset);
+      joint_angles = dataset.joint_angles();
+      xyz          = dataset.xyz();
+    }
+    else
+    {
+      out.status   = load_samples(job.joint_angles, job.positions, q, p, threads);
+      joint_angles = q;
+      xyz          = p;
+    }
+    out.load_seconds = std::chrono::duration<double>(Clock::now() - load_start).count();
+    if (!out.status) return out;
+
+    out.parameters.resize(4 * N);
+    double *const a = out.parameters.data(), *const alpha = a + N, *const d = a + 2 * N, *const theta = a + 3 * N;
+    std::copy(job.a.begin(), job.a.end(), a);
+    std::copy(job.alpha.begin(), job.alpha.end(), alpha);
+    std::copy(job.d.begin(), job.d.end(), d);
+    std::copy(job.theta.begin(), job.theta.end(), theta);
+
+    CalibrationOptions options;
+    options.num_threads        = int(threads);
+    options.training_fraction  = job.training_fraction;
+    options.max_num_iterations = job.max_num_iterations;
+
+    const auto           solve_start = Clock::now();
+    Calibrator<Robot, B> calibrator(joint_angles, xyz, a, alpha, d, theta, options);
+    for (const std::string &block : job.constant)
+      calibrator.problem().SetParameterBlockConstant(block == "a" ? a : block == "alpha" ? alpha : block == "d" ? d : theta);
+    out.summary       = calibrator.solve();
+    out.solve_seconds = std::chrono::duration<double>(Clock::now() - solve_start).count();
+
+    EvaluationOptions evaluation;
+    evaluation.num_threads = threads;
+    out.samples            = xyz.rows();
+    out.training           = calibrator.training_samples();
+    out.validation         = evaluate<Robot>(a, alpha, d, theta, joint_angles, xyz, out.training, out.samples, evaluation);
+    return out;
+  }
+
+  // Runs job with the instantiation of kc::robots matching its robot
+  [[nodiscard]] inline auto run_job(const FleetJob &job, const std::size_t threads) -> FleetResult
+  {
+    FleetResult out;
+    if (!robots::visit(job.robot, [&](auto tag) { out = run_job<typename decltype(tag)::type>(job, threads); }))
+    {
+      out.name   = job.name;
+      out.robot  = job.robot;
+      out.status = {LoadError::Format, 0, job.name + ": unknown robot " + job.robot};
+    }
+    return out;
+  }
+
+  // Threads given to each job's load, solve and evaluation. With W jobs running at a time every job
+  // gets num_threads / W threads on average, scaled by the size of its samples relative to the
+  // mean, so large arms solve on more threads than small ones.
+  [[nodiscard]] inline auto allot_threads(const std::vector<FleetJob> &jobs, const FleetOptions &options) -> std::vector<std::size_t>
+  {
+    std::vector<std::size_t> out(jobs.size(), 1);
+    if (jobs.empty()) return out;
+
+    const std::size_t threads    = std::max<std::size_t>(1, options.num_threads);
+    const std::size_t concurrent = std::min(jobs.size(), options.concurrent_jobs > 0 ? options.concurrent_jobs : threads);
+    const double      total      = std::accumulate(jobs.begin(), jobs.end(), 0., [](const double sum, const FleetJob &job) { return sum + double(job.bytes); });
+    const double      mean       = total / double(jobs.size());
+    for (std::size_t i{}; i < jobs.size(); ++i)
+    {
+      const double weight = mean > 0. ? double(jobs[i].bytes) / mean : 1.;
+      out[i]              = std::clamp<std::size_t>(std::size_t(std::lround(double(threads) / double(concurrent) * weight)), 1, threads);
+    }
+    return out;
+  }
+
+  // Writes result as a single JSON line
+  inline void write_result(std::ostream &out, const FleetResult &result)
+  {
+    const auto block = [&](const char *const key, const std::size_t index) {
+      const std::size_t N = result.parameters.size() / 4;
+      out << "," << detail::json_string(key) << ":[";
+      for (std::size_t i{}; i < N; ++i)
+        out << (i > 0 ? "," : "") << result.parameters[index * N + i];
+      out << "]";
+    };
+
+    out << std::setprecision(std::numeric_limits<double>::max_digits10)
+        << "{\"job\":" << detail::json_string(result.name)
+        << ",\"robot\":" << detail::json_string(result.robot)
+        << ",\"ok\":" << (result.status ? "true" : "false");
+    if (!result.status)
+    {
+      out << ",\"error\":" << detail::json_string(result.status.message) << "}\n";
+      return;
+    }
+    out << ",\"threads\":" << result.threads
+        << ",\"samples\":" << result.samples
+        << ",\"training\":" << result.training
+        << ",\"load_seconds\":" << result.load_seconds
+        << ",\"solve_seconds\":" << result.solve_seconds
+        << ",\"termination\":" << detail::json_string(ceres::TerminationTypeToString(result.summary.termination_type))
+        << ",\"iterations\":" << result.summary.iterations.size()
+        << ",\"initial_cost\":" << result.summary.initial_cost
+        << ",\"final_cost\":" << result.summary.final_cost
+        << ",\"validation\":{\"samples\":" << result.validation.samples
+        << ",\"rmse\":" << result.validation.rmse
+        << ",\"mean\":" << result.validation.mean
+        << ",\"max\":" << result.validation.max
+        << ",\"p95\":" << result.validation.p95
+        << ",\"p99\":" << result.validation.p99 << "}";
+    block("a", 0);
+    block("alpha", 1);
+    block("d", 2);
+    block("theta", 3);
+    out << "}\n";
+  }
+
+  // Calibrates every job of the fleet on a work-stealing pool of concurrent_jobs workers, largest
+  // jobs first, each solving on its allotment of threads (see allot_threads). Results are written
+  // to out as JSON lines in order of completion and flushed one by one, followed by a summary line.
+  // A job that throws, e.g. std::bad_alloc on samples too large for memory, is reported as failed.
+  inline auto run_fleet(const std::vector<FleetJob> &jobs, const FleetOptions &options, std::ostream &out) -> FleetSummary
+  {
+    using Clock = std::chrono::steady_clock;
+
+    const auto                     start   = Clock::now();
+    const std::vector<std::size_t> threads = allot_threads(jobs, options);
+
+    std::vector<std::size_t> order(jobs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](const std::size_t i, const std::size_t j) { return jobs[i].bytes > jobs[j].bytes; });
+
+    FleetSummary summary;
+    summary.jobs = jobs.size();
+    std::mutex mutex;
+    {
+      const std::size_t workers = std::min(jobs.size(), options.concurrent_jobs > 0 ? options.concurrent_jobs : std::max<std::size_t>(1, options.num_threads));
+      ThreadPool        pool(workers);
+      for (const std::size_t i : order)
+        pool.submit([&, i] {
+          FleetResult result;
+          try
+          {
+            result = run_job(jobs[i], threads[i]);
+          }
+          catch (const std::exception &exception)
+          {
+            result.name   = jobs[i].name;
+            result.robot  = jobs[i].robot;
+            result.status = {LoadError::Format, 0, jobs[i].name + ": " + exception.what()};
+          }
+          std::lock_guard<std::mutex> lock{mutex};
+          summary.failed += result.status ? 0 : 1;
+          write_result(out, result);
+          out.flush();
+        });
+      pool.wait();
+    }
+
+    summary.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    out << "{\"fleet\":{\"jobs\":" << summary.jobs << ",\"failed\":" << summary.failed << ",\"seconds\":" << summary.seconds << "}}\n";
+    out.flush();
+    return summary;
+  }
+} // namespace kc
+
+#endif // KC_FLEET_HPP_
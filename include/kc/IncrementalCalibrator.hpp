@@ -0,0 +1,176 @@
+#ifndef KC_INCREMENTALCALIBRATOR_HPP_
+#define KC_INCREMENTALCALIBRATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "kc/Robot.hpp"
+#include "kc/io.hpp"
+#include "kc/types.hpp"
+
+#include "Eigen/Dense"
+
+namespace kc
+{
+  struct IncrementalOptions
+  {
+    double decay{1.0};     // weight kept by the accumulated samples on every fold; < 1 forgets old data exponentially
+    double damping{1e-6};  // Levenberg-Marquardt damping, relative to the diagonal of J^T J
+    double prior{1e-12};   // absolute ridge keeping unobservable parameters at their current value
+    bool   bounded{true};  // a, alpha, d, theta >= 0 and alpha, theta <= 2 pi, as in kc::Calibrator
+  };
+
+  struct IncrementalSummary
+  {
+    std::size_t samples{}; // samples folded in so far
+    double      cost{};    // 1/2 sum of squared residuals, to first order at the current parameters
+    double      step_norm{};
+    double      time_in_seconds{};
+  };
+
+  // Recalibrates Robot as (q, p) samples stream in. The Gauss-Newton normal equations J^T J and
+  // J^T r over the 4N DH parameters (interleaved a, alpha, d, theta per link, the column order of
+  // Robot::jacobian) are accumulated at the current estimate, so folding in a batch costs
+  // O(batch N^2) and update() solves a single 4N x 4N system. After a step delta the accumulated
+  // gradient is carried to the new estimate as J^T r + J^T J delta, the linearisation of the
+  // samples that are no longer stored.
+  template<class Robot>
+  struct IncrementalCalibrator
+  {
+    static constexpr std::size_t N = Robot::N;
+    static constexpr std::size_t P = 4 * N;
+
+    using NormalMatrix    = Eigen::Matrix<double, P, P>;
+    using ParameterVector = Eigen::Matrix<double, P, 1>;
+
+    IncrementalCalibrator(const double *const a, const double *const alpha,
+                          const double *const d, const double *const theta,
+                          const IncrementalOptions &options = {})
+        : options_{options}
+    {
+      std::copy_n(a, N, this->a_.begin());
+      std::copy_n(alpha, N, this->alpha_.begin());
+      std::copy_n(d, N, this->d_.begin());
+      std::copy_n(theta, N, this->theta_.begin());
+      this->reset();
+    }
+
+    // Forgets every sample folded in so far, keeping the current parameters as the warm start.
+    void reset()
+    {
+      this->jtj_.setZero();
+      this->jtr_.setZero();
+      this->cost_    = 0.;
+      this->samples_ = 0;
+    }
+
+    // Keeps the parameter of link in block (0: a, 1: alpha, 2: d, 3: theta), or of every link, at
+    // its current value.
+    void set_constant(const std::size_t block, const std::size_t link) { this->constant_[4 * link + block] = true; }
+    void set_constant(const std::size_t block)
+    {
+      for (std::size_t link{}; link < N; ++link)
+        this->set_constant(block, link);
+    }
+
+    // Linearises the samples at the current parameters and adds them to the normal equations.
+    void add(const ColumnsView<N> &joint_angles, const ColumnsView<3> &xyz)
+    {
+      if (this->options_.decay < 1.)
+      {
+        this->jtj_ *= this->options_.decay;
+        this->jtr_ *= this->options_.decay;
+        this->cost_ *= this->options_.decay;
+      }
+
+      typename Robot::JacobianMatrix jacobian;
+      for (std::size_t i{}; i < xyz.rows(); ++i)
+      {
+        const PositionVector residual = Robot::fk_jacobian(this->a_.data(), this->alpha_.data(), this->d_.data(), this->theta_.data(),
+                                                           joint_angles.row(i), jacobian) -
+                                        xyz.row(i);
+        this->jtj_.template selfadjointView<Eigen::Lower>().rankUpdate(jacobian.transpose());
+        this->jtr_.noalias() += jacobian.transpose() * residual;
+        this->cost_ += 0.5 * residual.squaredNorm();
+      }
+      this->samples_ += xyz.rows();
+    }
+
+    // Takes one damped Gauss-Newton step on the accumulated normal equations.
+    auto update() -> IncrementalSummary
+    {
+      const auto start = std::chrono::steady_clock::now();
+
+      NormalMatrix jtj = this->jtj_.template selfadjointView<Eigen::Lower>();
+      for (std::size_t k{}; k < P; ++k)
+        if (this->constant_[k])
+        {
+          jtj.row(k).setZero();
+          jtj.col(k).setZero();
+        }
+
+      NormalMatrix system = jtj;
+      system.diagonal() += this->options_.damping * jtj.diagonal() + ParameterVector::Constant(this->options_.prior);
+      ParameterVector gradient = this->jtr_;
+      for (std::size_t k{}; k < P; ++k)
+        if (this->constant_[k])
+        {
+          system(k, k) = 1.;
+          gradient[k]  = 0.;
+        }
+
+      const ParameterVector step = this->apply(system.ldlt().solve(-gradient));
+      this->cost_ += gradient.dot(step) + 0.5 * step.dot(jtj * step);
+      this->jtr_.noalias() += jtj * step;
+
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      return {this->samples_, this->cost_, step.norm(), elapsed.count()};
+    }
+
+    [[nodiscard]] auto a() const -> const double * { return this->a_.data(); }
+    [[nodiscard]] auto alpha() const -> const double * { return this->alpha_.data(); }
+    [[nodiscard]] auto d() const -> const double * { return this->d_.data(); }
+    [[nodiscard]] auto theta() const -> const double * { return this->theta_.data(); }
+    [[nodiscard]] auto samples() const -> std::size_t { return this->samples_; }
+
+  private:
+    // Adds step to the parameters, clamped to the bounds, and returns the step actually taken.
+    // The constant parameters are left untouched, even when they lie outside the bounds.
+    auto apply(const ParameterVector &step) -> ParameterVector
+    {
+      constexpr double infinity = std::numeric_limits<double>::infinity();
+
+      ParameterVector taken;
+      std::array<double, N> *const blocks[] = {&this->a_, &this->alpha_, &this->d_, &this->theta_};
+      for (std::size_t link{}; link < N; ++link)
+        for (std::size_t block{}; block < 4; ++block)
+        {
+          if (this->constant_[4 * link + block])
+          {
+            taken[4 * link + block] = 0.;
+            continue;
+          }
+          double      &value = (*blocks[block])[link];
+          const double upper = (this->options_.bounded && (block == 1 || block == 3)) ? 2.0 * M_PI : infinity;
+          const double lower = this->options_.bounded ? 0. : -infinity;
+          const double next  = std::clamp(value + step[4 * link + block], lower, upper);
+          taken[4 * link + block] = next - value;
+          value                   = next;
+        }
+      return taken;
+    }
+
+    IncrementalOptions    options_;
+    std::array<double, N> a_, alpha_, d_, theta_;
+    std::array<bool, P>   constant_{};
+    NormalMatrix          jtj_; // lower triangle only
+    ParameterVector       jtr_;
+    double                cost_{};
+    std::size_t           samples_{};
+  };
+} // namespace kc
+
+#endif // KC_INCREMENTALCALIBRATOR_HPP_
@@ -0,0 +1,192 @@
+#ifndef KC_INVERSEKINEMATICS_HPP_
+#define KC_INVERSEKINEMATICS_HPP_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "kc/Robot.hpp"
+#include "kc/io.hpp"
+#include "kc/parallel.hpp"
+#include "kc/types.hpp"
+
+#include "Eigen/Dense"
+
+namespace kc
+{
+  struct IKOptions
+  {
+    std::size_t num_threads{default_threads()};
+    int         max_iterations{10}; // steps per target, which bounds its latency
+    double      tolerance{1e-7};    // [m] position error at which a target counts as reached
+    double      damping{1e-3};      // [m] lambda of the damped least-squares step, raised on a failed step
+    double      max_step{0.2};      // [rad or m] largest change of a joint per step
+  };
+
+  struct IKSummary
+  {
+    std::size_t targets{}, converged{};
+    int         max_iterations{}; // over every target
+    double      mean_iterations{};
+    double      max_error{}; // [m]
+    double      time_in_seconds{};
+  };
+
+  namespace detail
+  {
+    // Targets per chunk of a batched solve, small enough for the threads to balance the targets
+    // that need more steps.
+    inline constexpr std::size_t ik_chunk = 256;
+
+    struct IKPartial
+    {
+      std::size_t converged{}, iterations{};
+      int         max_iterations{};
+      double      max_error{};
+    };
+  } // namespace detail
+
+  // Positional inverse kinematics of Robot under a set of (calibrated) DH parameters, e.g. to
+  // correct commanded Cartesian targets on-line. Each target is solved by damped least squares,
+  // dq = J^T (J J^T + lambda^2 I)^-1 (p - fk(q)), from a seed such as the joint angles the nominal
+  // model gives for it; lambda grows tenfold on a step that does not reduce the error and shrinks
+  // back on one that does. For a redundant chain the step is the smallest joint change, so the
+  // solution stays close to the seed. At most options.max_iterations steps are taken per target,
+  // each one forward pass (Robot::fk_joint_jacobian) and a 3 x 3 solve.
+  template<class Robot>
+  struct InverseKinematics
+  {
+    static constexpr std::size_t N = Robot::N;
+
+    using JointAngles = typename Robot::JointAngles;
+
+    struct Solution
+    {
+      JointAngles q;
+      double      error{}; // [m] |p - fk(q)|
+      int         iterations{};
+      bool        converged{};
+    };
+
+    InverseKinematics(const double *const a, const double *const alpha,
+                      const double *const d, const double *const theta,
+                      const IKOptions &options = {})
+        : options_{options}, angles_{Robot::angles(alpha, theta)}
+    {
+      std::copy_n(a, N, this->a_.begin());
+      std::copy_n(d, N, this->d_.begin());
+    }
+
+    [[nodiscard]] auto solve(const PositionVector &target, const JointAngles &seed) const -> Solution
+    {
+      Solution out{seed};
+
+      typename Robot::JointJacobianMatrix jacobian, next_jacobian;
+      PositionVector                      error = target - this->fk(out.q, jacobian);
+      out.error                                 = error.norm();
+
+      const double damping = this->options_.damping * this->options_.damping;
+      double       lambda2 = damping;
+      while (out.error > this->options_.tolerance && out.iterations < this->options_.max_iterations)
+      {
+        ++out.iterations;
+        Eigen::Matrix3d system = jacobian * jacobian.transpose();
+        system.diagonal().array() += lambda2;
+        JointAngles  step    = jacobian.transpose() * system.llt().solve(error);
+        const double largest = step.cwiseAbs().maxCoeff();
+        if (largest > this->options_.max_step) step *= this->options_.max_step / largest;
+
+        const JointAngles    q          = out.q + step;
+        const PositionVector next_error = target - this->fk(q, next_jacobian);
+        const double         next_norm  = next_error.norm();
+        if (next_norm < out.error)
+        {
+          out.q     = q;
+          out.error = next_norm;
+          error     = next_error;
+          jacobian  = next_jacobian;
+          lambda2   = std::max(damping, 0.1 * lambda2);
+        }
+        else
+          lambda2 *= 10.;
+      }
+      out.converged = out.error <= this->options_.tolerance;
+      return out;
+    }
+
+    // Solves targets[i] from seeds[i] for every i, in chunks spread across options.num_threads
+    // threads, writing the joint angles to out (resized to match) and, if given, the final
+    // position errors to errors[i].
+    auto solve(const ColumnsView<3> &targets, const ColumnsView<N> &seeds, Columns<N> &out, double *const errors = nullptr) const -> IKSummary
+    {
+      constexpr std::size_t Chunk = detail::ik_chunk;
+
+      const auto start = std::chrono::steady_clock::now();
+      IKSummary  summary;
+      summary.targets = targets.rows();
+      out.resize(targets.rows());
+      if (summary.targets == 0) return summary;
+
+      const std::size_t              chunks = (summary.targets + Chunk - 1) / Chunk;
+      std::vector<detail::IKPartial> partials(chunks);
+      parallel_for(chunks, this->options_.num_threads, [&](const std::size_t chunk) {
+        detail::IKPartial &partial = partials[chunk];
+        const std::size_t  end     = std::min(summary.targets, (chunk + 1) * Chunk);
+        for (std::size_t i{chunk * Chunk}; i < end; ++i)
+        {
+          const Solution solution = this->solve(targets.row(i), seeds.row(i));
+          for (std::size_t joint{}; joint < N; ++joint)
+            out.data()[joint * summary.targets + i] = solution.q[joint];
+          if (errors != nullptr) errors[i] = solution.error;
+          partial.converged += solution.converged ? 1 : 0;
+          partial.iterations += std::size_t(solution.iterations);
+          partial.max_iterations = std::max(partial.max_iterations, solution.iterations);
+          partial.max_error      = std::max(partial.max_error, solution.error);
+        }
+      });
+
+      std::size_t iterations{};
+      for (const detail::IKPartial &partial : partials)
+      {
+        summary.converged += partial.converged;
+        iterations += partial.iterations;
+        summary.max_iterations = std::max(summary.max_iterations, partial.max_iterations);
+        summary.max_error      = std::max(summary.max_error, partial.max_error);
+      }
+      summary.mean_iterations = double(iterations) / double(summary.targets);
+      summary.time_in_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      return summary;
+    }
+
+    // Compensates joint angles commanded under the nominal DH parameters: the targets are where
+    // the nominal model puts the end-effector, fk_nominal(commanded), and they are solved under
+    // these parameters from the commanded angles.
+    auto compensate(const double *const a, const double *const alpha,
+                    const double *const d, const double *const theta,
+                    const ColumnsView<N> &commanded, Columns<N> &out, double *const errors = nullptr) const -> IKSummary
+    {
+      Columns<3> targets;
+      targets.resize(commanded.rows());
+      parallel_for((commanded.rows() + detail::ik_chunk - 1) / detail::ik_chunk, this->options_.num_threads, [&](const std::size_t chunk) {
+        const std::size_t first = chunk * detail::ik_chunk;
+        const std::size_t count = std::min(detail::ik_chunk, commanded.rows() - first);
+        Robot::fk_batch(a, alpha, d, theta, commanded.data() + first, commanded.rows(), count, targets.data() + first, commanded.rows());
+      });
+      return this->solve(targets, commanded, out, errors);
+    }
+
+  private:
+    auto fk(const JointAngles &q, typename Robot::JointJacobianMatrix &jacobian) const -> PositionVector
+    {
+      return Robot::fk_joint_jacobian(this->a_.data(), this->d_.data(), this->angles_, q, Robot::joint_sincos(q), jacobian);
+    }
+
+    IKOptions              options_;
+    std::array<double, N>  a_, d_;
+    typename Robot::Angles angles_;
+  };
+} // namespace kc
+
+#endif // KC_INVERSEKINEMATICS_HPP_
@@ -1,6 +1,7 @@
 #ifndef KC_LINK_HPP_
 #define KC_LINK_HPP_
 
+#include "kc/simd.hpp"
 #include "kc/types.hpp"
 
 namespace kc
@@ -20,27 +21,26 @@ namespace kc
     constexpr static auto is_revolute() -> bool { return LT == LinkType::Revolute; }
     constexpr static auto is_prismatic() -> bool { return LT == LinkType::Prismatic; }
 
-    [[nodiscard]] static auto jacobian(const double a, const double alpha,
-                                       const double d, const double theta,
-                                       const double      q,
-                                       const std::size_t index, const std::vector<TransformationMatrix> &transforms) -> TransformationMatrix
+    // Columns d(p)/d(a, alpha, d, theta) of the end-effector position, where pre is the product
+    // of the transforms preceding this link and post is the origin of the end-effector expressed
+    // in this link's frame (i.e. the translation column of the product of the following transforms).
+    template<class T>
+    [[nodiscard]] static auto jacobian(const T a, const T alpha,
+                                       const T d, const T theta,
+                                       const T                         q,
+                                       const TransformationMatrixT<T> &pre, const HomogeneousVectorT<T> &post) -> LinkJacobianT<T>
     {
       (void)d;
-      TransformationMatrix out, pre = TransformationMatrix::Identity(), post = TransformationMatrix::Identity();
-      for (std::size_t link = 0; link < index; ++link)
-        pre *= transforms[link];
-      for (std::size_t link{index + 1}; link < transforms.size(); ++link)
-        post *= transforms[link];
-
-      out.block(0, 0, 3, 1) = (pre * delta_a(theta, q) * post).block(0, 3, 3, 1);
-      out.block(0, 1, 3, 1) = (pre * delta_alpha(alpha, theta, q) * post).block(0, 3, 3, 1);
-      out.block(0, 2, 3, 1) = (pre * delta_d() * post).block(0, 3, 3, 1);
-      out.block(0, 3, 3, 1) = (pre * delta_theta(a, alpha, theta, q) * post).block(0, 3, 3, 1);
-
-      return out;
+      if constexpr (is_revolute())
+        return jacobian(a, alpha, theta + q, pre, post);
+      else if constexpr (is_prismatic())
+        return jacobian(a, alpha, theta, pre, post);
+      else
+        static_assert(always_false_v<LT>, "Invalid LinkType");
     }
 
-    [[nodiscard]] static auto transform(const double a, const double alpha, const double d, const double theta, const double q) -> TransformationMatrix
+    template<class T>
+    [[nodiscard]] static auto transform(const T a, const T alpha, const T d, const T theta, const T q) -> TransformationMatrixT<T>
     {
       if constexpr (is_revolute())
         return transform(a, alpha, d, theta + q);
@@ -50,6 +50,36 @@ namespace kc
         static_assert(always_false_v<LT>, "Invalid LinkType");
     }
 
+    // Same as transform and jacobian above from the sines and cosines of alpha, theta and q, which
+    // Robot computes once per parameter update (alpha, theta) and once per sample (q). theta + q of
+    // a revolute link is expanded by the angle-addition identities, so no transcendental is left.
+    template<class T>
+    [[nodiscard]] static auto transform(const T a, const T sin_alpha, const T cos_alpha,
+                                        const T d, const T sin_theta, const T cos_theta,
+                                        const T q, const T sin_q, const T cos_q) -> TransformationMatrixT<T>
+    {
+      if constexpr (is_revolute())
+        return transform_sincos(a, sin_alpha, cos_alpha, d, sin_theta * cos_q + cos_theta * sin_q, cos_theta * cos_q - sin_theta * sin_q);
+      else if constexpr (is_prismatic())
+        return transform_sincos(a, sin_alpha, cos_alpha, d + q, sin_theta, cos_theta);
+      else
+        static_assert(always_false_v<LT>, "Invalid LinkType");
+    }
+
+    template<class T>
+    [[nodiscard]] static auto jacobian(const T a, const T sin_alpha, const T cos_alpha,
+                                       const T sin_theta, const T cos_theta,
+                                       const T sin_q, const T cos_q,
+                                       const TransformationMatrixT<T> &pre, const HomogeneousVectorT<T> &post) -> LinkJacobianT<T>
+    {
+      if constexpr (is_revolute())
+        return jacobian_sincos(a, sin_alpha, cos_alpha, sin_theta * cos_q + cos_theta * sin_q, cos_theta * cos_q - sin_theta * sin_q, pre, post);
+      else if constexpr (is_prismatic())
+        return jacobian_sincos(a, sin_alpha, cos_alpha, sin_theta, cos_theta, pre, post);
+      else
+        static_assert(always_false_v<LT>, "Invalid LinkType");
+    }
+
     [[nodiscard]] static auto delta_a(const double theta, const double q) -> TransformationMatrix
     {
       if constexpr (is_revolute())
@@ -88,19 +118,99 @@ namespace kc
         static_assert(always_false_v<LT>, "Invalid LinkType");
     }
 
+    // Right-multiplies the top three rows of W homogeneous transforms, stored lane-wise in m, by
+    // this link's transform evaluated at W joint values q[0..W).
+    template<std::size_t W, class T>
+    static void transform_lanes(const T a, const T sin_alpha, const T cos_alpha,
+                                const T d, const T theta,
+                                const T *const q, T (&m)[3][4][W])
+    {
+      alignas(64) T angle[W], offset[W], sin_theta[W], cos_theta[W];
+      for (std::size_t lane{}; lane < W; ++lane)
+      {
+        if constexpr (is_revolute())
+        {
+          angle[lane]  = theta + q[lane];
+          offset[lane] = d;
+        }
+        else if constexpr (is_prismatic())
+        {
+          angle[lane]  = theta;
+          offset[lane] = d + q[lane];
+        }
+        else
+          static_assert(always_false_v<LT>, "Invalid LinkType");
+      }
+      simd::sincos<W>(angle, sin_theta, cos_theta);
+
+      for (std::size_t row{}; row < 3; ++row)
+        for (std::size_t lane{}; lane < W; ++lane)
+        {
+          const T m0 = m[row][0][lane], m1 = m[row][1][lane], m2 = m[row][2][lane];
+          const T x  = m0 * cos_theta[lane] + m1 * sin_theta[lane];
+          const T y  = m1 * cos_theta[lane] - m0 * sin_theta[lane];
+          m[row][0][lane] = x;
+          m[row][1][lane] = y * cos_alpha + m2 * sin_alpha;
+          m[row][2][lane] = m2 * cos_alpha - y * sin_alpha;
+          m[row][3][lane] += x * a + m2 * offset[lane];
+        }
+    }
+
   private:
-    [[nodiscard]] static auto transform(const double a, const double alpha, const double d, const double theta) -> TransformationMatrix
+    // sin and cos are found by argument-dependent lookup for scalars other than float and double
+    template<class T>
+    [[nodiscard]] static auto transform(const T a, const T alpha, const T d, const T theta) -> TransformationMatrixT<T>
     {
-      const double sin_alpha = std::sin(alpha), cos_alpha = std::cos(alpha);
-      const double sin_theta = std::sin(theta), cos_theta = std::cos(theta);
+      using std::cos;
+      using std::sin;
+      return transform_sincos(a, T(sin(alpha)), T(cos(alpha)), d, T(sin(theta)), T(cos(theta)));
+    }
+
+    template<class T>
+    [[nodiscard]] static auto transform_sincos(const T a, const T sin_alpha, const T cos_alpha,
+                                               const T d, const T sin_theta, const T cos_theta) -> TransformationMatrixT<T>
+    {
+      const T zero{0}, one{1};
       // clang-format off
-      return TransformationMatrix{{cos_theta, -sin_theta * cos_alpha,  sin_theta * sin_alpha, a * cos_theta},
-                                  {sin_theta,  cos_theta * cos_alpha, -cos_theta * sin_alpha, a * sin_theta},
-                                  {        0,              sin_alpha,              cos_alpha,             d},
-                                  {        0,                      0,                      0,             1}};
+      return TransformationMatrixT<T>{{cos_theta, -sin_theta * cos_alpha,  sin_theta * sin_alpha, a * cos_theta},
+                                      {sin_theta,  cos_theta * cos_alpha, -cos_theta * sin_alpha, a * sin_theta},
+                                      {     zero,              sin_alpha,              cos_alpha,             d},
+                                      {     zero,                   zero,                   zero,           one}};
       // clang-format on
     }
 
+    template<class T>
+    [[nodiscard]] static auto jacobian(const T a, const T alpha, const T theta,
+                                       const TransformationMatrixT<T> &pre, const HomogeneousVectorT<T> &post) -> LinkJacobianT<T>
+    {
+      using std::cos;
+      using std::sin;
+      return jacobian_sincos(a, T(sin(alpha)), T(cos(alpha)), T(sin(theta)), T(cos(theta)), pre, post);
+    }
+
+    // Expands pre * delta_zeta * post keeping only the non-zero entries of each delta matrix.
+    // Every delta has a zero last row, so only the rotation block of pre contributes, through
+    // x_theta / y_theta, the first two axes of pre rotated by theta about z.
+    template<class T>
+    [[nodiscard]] static auto jacobian_sincos(const T a, const T sin_alpha, const T cos_alpha,
+                                              const T sin_theta, const T cos_theta,
+                                              const TransformationMatrixT<T> &pre, const HomogeneousVectorT<T> &post) -> LinkJacobianT<T>
+    {
+      const auto                   rotation = pre.template topLeftCorner<3, 3>();
+      const Eigen::Matrix<T, 3, 1> x_theta  = rotation.col(0) * cos_theta + rotation.col(1) * sin_theta;
+      const Eigen::Matrix<T, 3, 1> y_theta  = rotation.col(1) * cos_theta - rotation.col(0) * sin_theta;
+
+      const T u = sin_alpha * post.y() + cos_alpha * post.z();
+      const T w = cos_alpha * post.y() - sin_alpha * post.z();
+
+      LinkJacobianT<T> out;
+      out.col(0) = x_theta;
+      out.col(1) = rotation.col(2) * w - y_theta * u;
+      out.col(2) = rotation.col(2);
+      out.col(3) = y_theta * (post.x() + a) - x_theta * w;
+      return out;
+    }
+
     [[nodiscard]] static auto delta_a(const double theta) -> TransformationMatrix
     {
       // clang-format off
@@ -0,0 +1,340 @@
+#ifndef KC_NATIVECALIBRATOR_HPP_
+#define KC_NATIVECALIBRATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "kc/Robot.hpp"
+#include "kc/evaluate.hpp"
+#include "kc/identifiability.hpp"
+#include "kc/io.hpp"
+#include "kc/parallel.hpp"
+#include "kc/types.hpp"
+
+#include "Eigen/Dense"
+
+namespace kc
+{
+  // Defaults follow ceres::Solver::Options, so that both solvers stop at comparable points.
+  struct NativeOptions
+  {
+    std::size_t            num_threads{default_threads()};
+    double                 training_fraction{0.8}; // leading fraction of the samples used for the fit
+    int                    max_num_iterations{50};
+    double                 function_tolerance{1e-6};
+    double                 gradient_tolerance{1e-10};
+    double                 parameter_tolerance{1e-8};
+    double                 initial_trust_region_radius{1e4};
+    bool                   minimizer_progress_to_stdout{false};
+    bool                   bounded{true};            // a, alpha, d, theta >= 0 and alpha, theta <= 2 pi, as in kc::Calibrator
+    bool                   fix_unidentifiable{true}; // hold constant the parameters kc::identifiability marks fixed
+    IdentifiabilityOptions identifiability{};
+  };
+
+  struct NativeSummary
+  {
+    double initial_cost{}, final_cost{}; // 1/2 sum of weighted squared residuals
+    int    iterations{}, successful_steps{}, unsuccessful_steps{};
+    bool   converged{};
+    double total_time_in_seconds{}, evaluation_time_in_seconds{}, linear_solver_time_in_seconds{};
+  };
+
+  // Levenberg-Marquardt calibration of Robot without Ceres. Each iteration evaluates the samples
+  // once, in chunks spread across threads, and folds their Jacobians straight into per-chunk normal
+  // equations J^T J and J^T r over the 4N DH parameters (interleaved a, alpha, d, theta per link,
+  // the column order of Robot::jacobian), so the 3 x 4N Jacobian of a sample never outlives its
+  // evaluation and memory does not grow with the iteration count. The chunks are reduced in order,
+  // which keeps the result independent of the number of threads, and the damped 4N x 4N system is
+  // solved by LDLT. The trust region follows Ceres' LEVENBERG_MARQUARDT strategy; the bounds are
+  // enforced by clamping each step onto the box.
+  template<class Robot>
+  struct NativeCalibrator
+  {
+    static constexpr std::size_t N = Robot::N;
+    static constexpr std::size_t P = 4 * N;
+
+    using NormalMatrix    = Eigen::Matrix<double, P, P>;
+    using ParameterVector = Eigen::Matrix<double, P, 1>;
+
+    // Trains on the leading options.training_fraction of the samples
+    NativeCalibrator(const ColumnsView<N> &joint_angles, const ColumnsView<3> &xyz,
+                     double *a, double *alpha, double *d, double *theta,
+                     const NativeOptions &options = {})
+        : NativeCalibrator(joint_angles, xyz, {{0, std::min(xyz.rows(), std::size_t(double(xyz.rows()) * options.training_fraction))}},
+                           a, alpha, d, theta, options)
+    {
+    }
+
+    // Trains on the given sample ranges, with one weight per sample of the dataset if given, as
+    // kc::Calibrator does. The parameters are updated in place by solve().
+    NativeCalibrator(const ColumnsView<N> &joint_angles, const ColumnsView<3> &xyz,
+                     const std::vector<SampleRange> &training,
+                     double *a, double *alpha, double *d, double *theta,
+                     const NativeOptions &options = {}, const double *const weights = nullptr)
+        : joint_angles_{joint_angles}, xyz_{xyz}, weights_{weights}, options_{options}, blocks_{a, alpha, d, theta}
+    {
+      constexpr std::size_t Chunk = detail::evaluation_chunk;
+
+      for (const auto &[begin, end] : training)
+        for (std::size_t first{begin}; first < end; first += Chunk)
+        {
+          this->chunks_.push_back({first, std::min(end, first + Chunk), this->training_});
+          this->training_ += this->chunks_.back().end - first;
+        }
+      this->normals_.resize(this->chunks_.size());
+
+      // The joint angles stay fixed, so their sines and cosines are taken once
+      this->joints_.resize(this->training_);
+      parallel_for(this->chunks_.size(), options.num_threads, [&](const std::size_t chunk) {
+        const Span &range = this->chunks_[chunk];
+        for (std::size_t i{range.begin}; i < range.end; ++i)
+          this->joints_[range.offset + i - range.begin] = Robot::joint_sincos(joint_angles.row(i));
+      });
+
+      if (!options.fix_unidentifiable) return;
+      this->identifiability_ = kc::identifiability<Robot>(a, alpha, d, theta, joint_angles, training, options.identifiability);
+      for (std::size_t block{}; block < 4; ++block)
+        for (const int link : this->identifiability_.fixed[block])
+          this->set_constant(block, std::size_t(link));
+    }
+
+    // Keeps the parameter of link in block (0: a, 1: alpha, 2: d, 3: theta), or of every link, at
+    // its current value.
+    void set_constant(const std::size_t block, const std::size_t link) { this->constant_[4 * link + block] = true; }
+    void set_constant(const std::size_t block)
+    {
+      for (std::size_t link{}; link < N; ++link)
+        this->set_constant(block, link);
+    }
+
+    [[nodiscard]] auto training_samples() const -> std::size_t { return this->training_; }
+    [[nodiscard]] auto validation_samples() const -> std::size_t { return this->xyz_.rows() - this->training_; }
+    [[nodiscard]] auto identifiability() const -> const Identifiability & { return this->identifiability_; }
+
+    auto solve() -> NativeSummary
+    {
+      using Clock = std::chrono::steady_clock;
+
+      constexpr double min_relative_decrease = 1e-3;
+      constexpr double min_trust_region      = 1e-32, max_trust_region = 1e16;
+      constexpr double min_diagonal          = 1e-6, max_diagonal = 1e32;
+
+      const auto    start = Clock::now();
+      NativeSummary summary;
+
+      const auto evaluate = [&](const ParameterVector &x, NormalMatrix &jtj, ParameterVector &jtr) {
+        const auto   begin = Clock::now();
+        const double cost  = this->linearise(x, jtj, jtr);
+        summary.evaluation_time_in_seconds += std::chrono::duration<double>(Clock::now() - begin).count();
+        return cost;
+      };
+
+      ParameterVector x = this->parameters();
+      NormalMatrix    jtj, candidate_jtj;
+      ParameterVector jtr, candidate_jtr;
+      double          cost = evaluate(x, jtj, jtr);
+      summary.initial_cost = summary.final_cost = cost;
+
+      double radius = this->options_.initial_trust_region_radius, decrease_factor = 2.;
+      if (this->options_.minimizer_progress_to_stdout)
+        std::cout << "iter      cost      cost_change  |gradient|   |step|    tr_ratio  tr_radius\n";
+
+      while (summary.iterations < this->options_.max_num_iterations)
+      {
+        for (std::size_t k{}; k < P; ++k)
+          if (this->constant_[k]) jtr[k] = 0.;
+
+        // Projected gradient: the part of a gradient step the bounds let through
+        const double gradient = (this->clamp(x - jtr) - x).template lpNorm<Eigen::Infinity>();
+        if (gradient <= this->options_.gradient_tolerance)
+        {
+          summary.converged = true;
+          break;
+        }
+        ++summary.iterations;
+
+        const auto   linear = Clock::now();
+        NormalMatrix system = jtj.template selfadjointView<Eigen::Lower>();
+        system.diagonal() += jtj.diagonal().cwiseMax(min_diagonal).cwiseMin(max_diagonal) / radius;
+        for (std::size_t k{}; k < P; ++k)
+          if (this->constant_[k])
+          {
+            system.row(k).setZero();
+            system.col(k).setZero();
+            system(k, k) = 1.;
+          }
+        const ParameterVector step = this->clamp(x + system.ldlt().solve(-jtr)) - x;
+        summary.linear_solver_time_in_seconds += std::chrono::duration<double>(Clock::now() - linear).count();
+
+        if (step.norm() <= this->options_.parameter_tolerance * (x.norm() + this->options_.parameter_tolerance))
+        {
+          summary.converged = true;
+          break;
+        }
+
+        // Decrease predicted by the Gauss-Newton model against the one achieved. The candidate is
+        // linearised along with its cost, which a rejected step wastes but an accepted one, the
+        // common case, reuses as the next iteration's normal equations.
+        const double model = -(jtr.dot(step) + 0.5 * step.dot(jtj.template selfadjointView<Eigen::Lower>() * step));
+        const double next  = evaluate(x + step, candidate_jtj, candidate_jtr);
+        const double ratio = (model > 0. && std::isfinite(next)) ? (cost - next) / model : -1.;
+
+        if (this->options_.minimizer_progress_to_stdout)
+          std::cout << std::setw(4) << summary.iterations << std::scientific << std::setprecision(6)
+                    << std::setw(14) << cost << std::setw(12) << std::setprecision(2) << cost - next
+                    << std::setw(12) << gradient << std::setw(10) << step.norm()
+                    << std::setw(10) << ratio << std::setw(10) << radius << std::defaultfloat << "\n";
+
+        if (ratio <= min_relative_decrease)
+        {
+          ++summary.unsuccessful_steps;
+          radius /= decrease_factor;
+          decrease_factor *= 2.;
+          if (radius < min_trust_region)
+          {
+            summary.converged = true;
+            break;
+          }
+          continue;
+        }
+
+        ++summary.successful_steps;
+        radius          = std::min(max_trust_region, radius / std::max(1. / 3., 1. - std::pow(2. * ratio - 1., 3)));
+        decrease_factor = 2.;
+
+        const bool converged = cost - next <= this->options_.function_tolerance * cost;
+        x += step;
+        cost = next;
+        std::swap(jtj, candidate_jtj);
+        std::swap(jtr, candidate_jtr);
+        if (converged)
+        {
+          summary.converged = true;
+          break;
+        }
+      }
+
+      this->assign(x);
+      summary.final_cost            = cost;
+      summary.total_time_in_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+      return summary;
+    }
+
+  private:
+    struct Span
+    {
+      std::size_t begin, end, offset; // samples [begin, end) of the dataset, from joints_[offset]
+    };
+
+    struct Normal
+    {
+      NormalMatrix    jtj; // lower triangle only
+      ParameterVector jtr;
+      double          cost{};
+    };
+
+    [[nodiscard]] auto parameters() const -> ParameterVector
+    {
+      ParameterVector out;
+      for (std::size_t link{}; link < N; ++link)
+        for (std::size_t block{}; block < 4; ++block)
+          out[4 * link + block] = this->blocks_[block][link];
+      return out;
+    }
+
+    void assign(const ParameterVector &x) const
+    {
+      for (std::size_t link{}; link < N; ++link)
+        for (std::size_t block{}; block < 4; ++block)
+          this->blocks_[block][link] = x[4 * link + block];
+    }
+
+    // x clamped to the bounds, except the constant parameters, which keep their value even when
+    // it starts outside the box
+    [[nodiscard]] auto clamp(ParameterVector x) const -> ParameterVector
+    {
+      if (!this->options_.bounded) return x;
+      for (std::size_t link{}; link < N; ++link)
+        for (std::size_t block{}; block < 4; ++block)
+        {
+          if (this->constant_[4 * link + block]) continue;
+          const double upper = (block == 1 || block == 3) ? 2.0 * M_PI : std::numeric_limits<double>::infinity();
+          x[4 * link + block] = std::clamp(x[4 * link + block], 0., upper);
+        }
+      return x;
+    }
+
+    // Normal equations and cost of the training samples at x. The sample Jacobians are stacked
+    // Stack at a time so that J^T J grows by rank-(3 Stack) updates rather than Stack rank-3 ones.
+    auto linearise(const ParameterVector &x, NormalMatrix &jtj, ParameterVector &jtr) -> double
+    {
+      constexpr std::size_t Stack = 32;
+
+      std::array<std::array<double, N>, 4> blocks;
+      for (std::size_t link{}; link < N; ++link)
+        for (std::size_t block{}; block < 4; ++block)
+          blocks[block][link] = x[4 * link + block];
+      const typename Robot::Angles angles = Robot::angles(blocks[1].data(), blocks[3].data());
+
+      parallel_for(this->chunks_.size(), this->options_.num_threads, [&](const std::size_t chunk) {
+        const Span &range  = this->chunks_[chunk];
+        Normal      &normal = this->normals_[chunk];
+        normal.jtj.setZero();
+        normal.jtr.setZero();
+        normal.cost = 0.;
+
+        typename Robot::JacobianMatrix        jacobian;
+        Eigen::Matrix<double, P, 3 * Stack> stacked;
+        std::size_t                         filled{};
+        for (std::size_t i{range.begin}; i < range.end; ++i)
+        {
+          const double         weight   = this->weights_ != nullptr ? this->weights_[i] : 1.;
+          const PositionVector residual = Robot::fk_jacobian(blocks[0].data(), blocks[2].data(), angles, this->joint_angles_.row(i),
+                                                             this->joints_[range.offset + i - range.begin], jacobian) -
+                                          this->xyz_.row(i);
+          normal.jtr.noalias() += weight * (jacobian.transpose() * residual);
+          normal.cost += 0.5 * weight * residual.squaredNorm();
+          stacked.template middleCols<3>(Eigen::Index(3 * filled)) = std::sqrt(weight) * jacobian.transpose();
+          if (++filled == Stack)
+          {
+            normal.jtj.template selfadjointView<Eigen::Lower>().rankUpdate(stacked);
+            filled = 0;
+          }
+        }
+        if (filled > 0)
+          normal.jtj.template selfadjointView<Eigen::Lower>().rankUpdate(stacked.leftCols(Eigen::Index(3 * filled)));
+      });
+
+      jtj.setZero();
+      jtr.setZero();
+      double cost{};
+      for (const Normal &normal : this->normals_)
+      {
+        jtj += normal.jtj;
+        jtr += normal.jtr;
+        cost += normal.cost;
+      }
+      return cost;
+    }
+
+    ColumnsView<N>                           joint_angles_;
+    ColumnsView<3>                           xyz_;
+    const double                            *weights_;
+    NativeOptions                            options_;
+    std::array<double *, 4>                  blocks_; // a, alpha, d, theta of the caller
+    std::array<bool, P>                      constant_{};
+    std::size_t                              training_{};
+    std::vector<Span>                        chunks_;
+    std::vector<Normal>                      normals_;
+    std::vector<typename Robot::JointSinCos> joints_;
+    Identifiability                          identifiability_;
+  };
+} // namespace kc
+
+#endif // KC_NATIVECALIBRATOR_HPP_
@@ -0,0 +1,117 @@
+#ifndef KC_POSECOSTFUNCTION_HPP_
+#define KC_POSECOSTFUNCTION_HPP_
+
+#include <cmath>
+
+#include "kc/Robot.hpp"
+#include "kc/io.hpp"
+#include "kc/telemetry.hpp"
+
+#include "Eigen/Dense"
+#include "ceres/ceres.h"
+
+namespace kc
+{
+  namespace so3
+  {
+    // Rotation vector phi (axis times angle in [0, pi]) of R = exp([phi]x)
+    [[nodiscard]] inline auto log(const Eigen::Matrix3d &R) -> Eigen::Vector3d
+    {
+      const Eigen::AngleAxisd rotation{R};
+      return rotation.angle() * rotation.axis();
+    }
+
+    // J_l^-1(phi), mapping a world-frame rotation omega of exp([phi]x) to the change of phi:
+    // log(exp([omega]x) exp([phi]x)) = phi + J_l^-1(phi) omega to first order
+    [[nodiscard]] inline auto left_jacobian_inverse(const Eigen::Vector3d &phi) -> Eigen::Matrix3d
+    {
+      const double          angle = phi.norm();
+      const Eigen::Matrix3d hat{{0., -phi.z(), phi.y()},
+                                {phi.z(), 0., -phi.x()},
+                                {-phi.y(), phi.x(), 0.}};
+      // (1 - angle sin(angle) / (2 (1 - cos(angle)))) / angle^2, whose series is 1/12 + angle^2/720 +
+      // angle^4/30240: below 0.1 rad the closed form loses more to cancellation than the series
+      const double c = angle < 1e-1 ? 1. / 12. + angle * angle * (1. / 720. + angle * angle / 30240.)
+                                    : (1. - angle * std::sin(angle) / (2. * (1. - std::cos(angle)))) / (angle * angle);
+      return Eigen::Matrix3d::Identity() - 0.5 * hat + c * hat * hat;
+    }
+  } // namespace so3
+
+  // Pose residual of one sample: the position error and, scaled by orientation_scale [m/rad] so
+  // that both weigh comparably, the rotation error log(R R_measured^T) of the end-effector, all
+  // scaled by sqrt(weight). The Jacobian comes from Robot::fk_pose_jacobian, one pass over the
+  // chain for both.
+  template<class Robot>
+  struct PoseCostFunction : public ceres::SizedCostFunction<6, Robot::N, Robot::N, Robot::N, Robot::N>
+  {
+    PoseCostFunction(const typename Robot::JointAngles &x, const PositionVector &y, const Eigen::Quaterniond &orientation,
+                     const double orientation_scale = 1., const double weight = 1.)
+        : x_{x}, joints_{Robot::joint_sincos(x)}, y_{y}, rotation_t_{orientation.normalized().toRotationMatrix().transpose()},
+          scale_{std::sqrt(weight)}, orientation_scale_{orientation_scale * std::sqrt(weight)} {}
+    virtual ~PoseCostFunction() {}
+    virtual bool Evaluate(double const *const *parameters,
+                          double *             residuals,
+                          double **            jacobians) const
+    {
+      KC_TELEMETRY_TIME(Evaluate);
+      const typename Robot::Angles      &angles = Robot::cached_angles(parameters[1], parameters[3]);
+      typename Robot::PoseJacobianMatrix jac;
+      const TransformationMatrix         pose = (jacobians == nullptr)
+                                                    ? Robot::fk_pose(parameters[0], parameters[2], angles, this->x_, this->joints_)
+                                                    : Robot::fk_pose_jacobian(parameters[0], parameters[2], angles, this->x_, this->joints_, jac);
+      const Eigen::Vector3d              phi  = so3::log(pose.topLeftCorner<3, 3>() * this->rotation_t_);
+      for (std::size_t row{}; row < 3; ++row)
+      {
+        residuals[row]     = this->scale_ * (pose(row, 3) - this->y_[row]);
+        residuals[row + 3] = this->orientation_scale_ * phi[row];
+      }
+
+      if (jacobians == nullptr) return true;
+
+      jac.topRows(3) *= this->scale_;
+      jac.bottomRows(3) = this->orientation_scale_ * so3::left_jacobian_inverse(phi) * jac.bottomRows(3);
+      for (std::size_t i{}; i < 4; ++i)
+      {
+        std::size_t counter{};
+        if (jacobians[i] != nullptr)
+          for (std::size_t row{}; row < 6; ++row)
+            for (std::size_t col{i}; col < Robot::N * 4; col += 4)
+              jacobians[i][counter++] = jac(row, col);
+      }
+      return true;
+    }
+
+    static auto create(const typename Robot::JointAngles &x, const PositionVector &y, const Eigen::Quaterniond &orientation,
+                       const double orientation_scale = 1., const double weight = 1.) -> ceres::CostFunction *
+    {
+      return new PoseCostFunction<Robot>(x, y, orientation, orientation_scale, weight);
+    }
+
+  private:
+    typename Robot::JointAngles x_;
+    typename Robot::JointSinCos joints_;
+    PositionVector              y_;
+    Eigen::Matrix3d             rotation_t_; // R_measured^T
+    double                      scale_, orientation_scale_;
+  };
+
+  // Adds one kc::PoseCostFunction per sample in [begin, end). orientations holds the measured
+  // unit quaternions as w, x, y, z columns, e.g. read by kc::load_columns<4>.
+  template<class Robot>
+  void add_pose_residuals(ceres::Problem &problem,
+                          const ColumnsView<Robot::N> &joint_angles, const ColumnsView<3> &xyz, const ColumnsView<4> &orientations,
+                          const std::size_t begin, const std::size_t end,
+                          double *a, double *alpha, double *d, double *theta,
+                          const double orientation_scale = 1., const double *const weights = nullptr)
+  {
+    for (std::size_t i{begin}; i < end; ++i)
+    {
+      const Eigen::Quaterniond orientation{orientations.column(0)[i], orientations.column(1)[i], orientations.column(2)[i], orientations.column(3)[i]};
+      problem.AddResidualBlock(PoseCostFunction<Robot>::create(joint_angles.row(i), xyz.row(i), orientation, orientation_scale,
+                                                               weights != nullptr ? weights[i] : 1.),
+                               nullptr, a, alpha, d, theta);
+    }
+  }
+} // namespace kc
+
+#endif // KC_POSECOSTFUNCTION_HPP_
@@ -1,9 +1,16 @@
 #ifndef KC_ROBOT_HPP_
 #define KC_ROBOT_HPP_
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string>
+#include <type_traits>
 #include <utility>
 
 #include "kc/Link.hpp"
+#include "kc/simd.hpp"
+#include "kc/telemetry.hpp"
 #include "kc/types.hpp"
 
 #include "Eigen/Dense"
@@ -27,64 +34,406 @@ namespace kc
   {
     static constexpr std::size_t N = LinksCounter<Robot<Links...>>;
 
-    using JointAngles    = Vector<N>;
-    using JacobianMatrix = Eigen::Matrix<double, 3, 4 * N>;
+    template<class T>
+    using JointAnglesT = Vector<N, T>;
+    template<class T>
+    using JacobianMatrixT = Eigen::Matrix<T, 3, 4 * N>;
 
-    template<std::size_t... Is>
-    static auto fk_internal(const double *const a, const double *const alpha,
-                            const double *const d, const double *const theta,
-                            const JointAngles &q, std::index_sequence<Is...>) -> PositionVector
+    using JointAngles         = JointAnglesT<double>;
+    using JacobianMatrix      = JacobianMatrixT<double>;
+    using PoseJacobianMatrix  = Eigen::Matrix<double, 6, 4 * N>;
+    using JointJacobianMatrix = Eigen::Matrix<double, 3, N>; // d(p)/d(q)
+
+    // Joint sequence of the chain, e.g. "RRPRRR" for the Stanford arm
+    [[nodiscard]] static auto shape() -> std::string { return {(Links::is_revolute() ? 'R' : 'P')...}; }
+
+    template<class T, std::size_t... Is>
+    static auto fk_internal(const T *const a, const T *const alpha,
+                            const T *const d, const T *const theta,
+                            const JointAnglesT<T> &q, std::index_sequence<Is...>) -> TransformationMatrixT<T>
+    {
+      return (TransformationMatrixT<T>::Identity() *
+              ... *
+              Links::transform(a[Is], alpha[Is], d[Is], theta[Is], q[Is]));
+    }
+
+    // The kinematics are templated on the scalar T of the DH parameters: float for the
+    // mixed-precision paths, ceres::Jet for automatic differentiation. T is deduced from the DH
+    // parameters only, so joint angles given as Eigen expressions convert as for double.
+    template<class T>
+    static auto fk(const T *const a, const T *const alpha,
+                   const T *const d, const T *const theta,
+                   const NonDeduced<JointAnglesT<T>> &q) -> PositionVectorT<T>
     {
-      TransformationMatrix out = (TransformationMatrix::Identity() *
-                                  ... *
-                                  Links::transform(a[Is], alpha[Is], d[Is], theta[Is], q[Is]));
-      return out.block(0, 3, 3, 1);
+      KC_TELEMETRY_COUNT(FK, 1);
+      return fk_internal(a, alpha, d, theta, q, std::index_sequence_for<Links...>{}).block(0, 3, 3, 1);
     }
 
-    static auto fk(const double *const a, const double *const alpha,
-                   const double *const d, const double *const theta,
-                   const JointAngles &q) -> PositionVector
+    // End-effector pose, of which fk is the translation
+    template<class T>
+    static auto fk_pose(const T *const a, const T *const alpha,
+                        const T *const d, const T *const theta,
+                        const NonDeduced<JointAnglesT<T>> &q) -> TransformationMatrixT<T>
     {
+      KC_TELEMETRY_COUNT(FK, 1);
       return fk_internal(a, alpha, d, theta, q, std::index_sequence_for<Links...>{});
     }
 
-    template<std::size_t... Is>
-    static auto jacobian_internal(const double *const a, const double *const alpha,
-                                  const double *const d, const double *const theta,
-                                  const JointAngles &                      q,
-                                  const std::vector<TransformationMatrix> &transforms,
-                                  std::index_sequence<Is...>) -> std::vector<TransformationMatrix>
-    {
-      std::vector<TransformationMatrix> out;
-      out.reserve(N);
-      (out.push_back(Links::jacobian(a[Is], alpha[Is], d[Is], theta[Is], q[Is], Is, transforms)), ...);
-      return out;
+    template<std::size_t W, class T, std::size_t... Is>
+    static void fk_lanes(const T *const a, const T *const sin_alpha, const T *const cos_alpha,
+                         const T *const d, const T *const theta,
+                         const T *const q_soa, const std::size_t stride,
+                         T (&m)[3][4][W], std::index_sequence<Is...>)
+    {
+      (Links::template transform_lanes<W>(a[Is], sin_alpha[Is], cos_alpha[Is], d[Is], theta[Is], q_soa + Is * stride, m), ...);
     }
 
-    static auto jacobian(const double *const a, const double *const alpha,
+    // Forward kinematics of count configurations. q_soa holds joint j of sample s at
+    // q_soa[j * count + s] and the positions are written the same way, xyz_out[k * count + s].
+    // Samples are processed simd::lanes<Lane> at a time; the remainder goes through fk. The
+    // kinematics runs in Lane, by default the scalar of the joint angles and positions: with Lane =
+    // float twice as many lanes fit a register, at a position error of a few float ulps of the
+    // reach, and double data is converted one register block at a time (fk_batch<double, float>).
+    template<class T, class Lane = T>
+    static void fk_batch(const double *const a, const double *const alpha,
                          const double *const d, const double *const theta,
-                         const JointAngles &q) -> JacobianMatrix
+                         const T *const q_soa, const std::size_t count, T *const xyz_out)
     {
-      const auto transforms = getTransforms(a, alpha, d, theta, q, std::index_sequence_for<Links...>{});
-      const auto jacobians  = jacobian_internal(a, alpha, d, theta, q, transforms, std::index_sequence_for<Links...>{});
+      fk_batch<T, Lane>(a, alpha, d, theta, q_soa, count, count, xyz_out, count);
+    }
 
-      JacobianMatrix out;
+    // Same as above over columns spaced q_stride (joint angles) and xyz_stride (positions) apart,
+    // e.g. a range of samples of a longer kc::ColumnsView.
+    template<class T, class Lane = T>
+    static void fk_batch(const double *const a, const double *const alpha,
+                         const double *const d, const double *const theta,
+                         const T *const q_soa, const std::size_t q_stride, const std::size_t count,
+                         T *const xyz_out, const std::size_t xyz_stride)
+    {
+      constexpr std::size_t W = simd::lanes<Lane>;
+      KC_TELEMETRY_COUNT(FKBatch, 1);
+      KC_TELEMETRY_COUNT(FKBatchSamples, count);
+
+      std::array<Lane, N> a_t, alpha_t, d_t, theta_t, sin_alpha, cos_alpha;
       for (std::size_t link{}; link < N; ++link)
-        out.block(0, link * 4, 3, 4) = jacobians[link].block(0, 0, 3, 4);
+      {
+        a_t[link]       = Lane(a[link]);
+        alpha_t[link]   = Lane(alpha[link]);
+        d_t[link]       = Lane(d[link]);
+        theta_t[link]   = Lane(theta[link]);
+        sin_alpha[link] = Lane(std::sin(alpha[link]));
+        cos_alpha[link] = Lane(std::cos(alpha[link]));
+      }
+
+      std::size_t sample{};
+      for (; sample + W <= count; sample += W)
+      {
+        alignas(64) Lane m[3][4][W];
+        for (std::size_t row{}; row < 3; ++row)
+          for (std::size_t col{}; col < 4; ++col)
+            for (std::size_t lane{}; lane < W; ++lane)
+              m[row][col][lane] = (row == col) ? Lane(1) : Lane(0);
+
+        if constexpr (std::is_same_v<T, Lane>)
+          fk_lanes<W>(a_t.data(), sin_alpha.data(), cos_alpha.data(), d_t.data(), theta_t.data(), q_soa + sample, q_stride, m,
+                      std::index_sequence_for<Links...>{});
+        else
+        {
+          alignas(64) Lane q[N][W];
+          for (std::size_t joint{}; joint < N; ++joint)
+            for (std::size_t lane{}; lane < W; ++lane)
+              q[joint][lane] = Lane(q_soa[joint * q_stride + sample + lane]);
+          fk_lanes<W>(a_t.data(), sin_alpha.data(), cos_alpha.data(), d_t.data(), theta_t.data(), &q[0][0], W, m,
+                      std::index_sequence_for<Links...>{});
+        }
+
+        for (std::size_t row{}; row < 3; ++row)
+          for (std::size_t lane{}; lane < W; ++lane)
+            xyz_out[row * xyz_stride + sample + lane] = T(m[row][3][lane]);
+      }
+
+      JointAnglesT<Lane> q;
+      for (; sample < count; ++sample)
+      {
+        for (std::size_t joint{}; joint < N; ++joint)
+          q[joint] = Lane(q_soa[joint * q_stride + sample]);
+        const PositionVectorT<Lane> xyz = fk(a_t.data(), alpha_t.data(), d_t.data(), theta_t.data(), q);
+        for (std::size_t row{}; row < 3; ++row)
+          xyz_out[row * xyz_stride + sample] = T(xyz[row]);
+      }
+    }
+
+    // Sines and cosines of the DH angles alpha and theta, shared by every sample evaluated at the
+    // same parameters, and of the joint angles of one sample, fixed for a residual block. With
+    // both, fk and fk_jacobian below need no transcendental function.
+    template<class T>
+    struct AnglesT
+    {
+      std::array<T, N> sin_alpha, cos_alpha, sin_theta, cos_theta;
+
+      template<class U>
+      [[nodiscard]] auto cast() const -> AnglesT<U>
+      {
+        AnglesT<U> out;
+        for (std::size_t link{}; link < N; ++link)
+        {
+          out.sin_alpha[link] = U(this->sin_alpha[link]);
+          out.cos_alpha[link] = U(this->cos_alpha[link]);
+          out.sin_theta[link] = U(this->sin_theta[link]);
+          out.cos_theta[link] = U(this->cos_theta[link]);
+        }
+        return out;
+      }
+    };
+
+    template<class T>
+    struct JointSinCosT
+    {
+      JointAnglesT<T> sin, cos;
+    };
 
+    using Angles      = AnglesT<double>;
+    using JointSinCos = JointSinCosT<double>;
+
+    template<class T>
+    static auto angles(const T *const alpha, const T *const theta) -> AnglesT<T>
+    {
+      using std::cos;
+      using std::sin;
+      AnglesT<T> out;
+      for (std::size_t link{}; link < N; ++link)
+      {
+        out.sin_alpha[link] = sin(alpha[link]);
+        out.cos_alpha[link] = cos(alpha[link]);
+        out.sin_theta[link] = sin(theta[link]);
+        out.cos_theta[link] = cos(theta[link]);
+      }
       return out;
     }
 
-    template<std::size_t... Is>
-    static auto getTransforms(const double *const a, const double *const alpha,
-                              const double *const d, const double *const theta,
-                              const JointAngles &q, std::index_sequence<Is...>) -> std::vector<TransformationMatrix>
+    // angles(alpha, theta), recomputed only when they differ from the previous call of this
+    // thread: the residual blocks a thread evaluates within a solver iteration share one set.
+    static auto cached_angles(const double *const alpha, const double *const theta) -> const Angles &
+    {
+      thread_local struct
+      {
+        std::array<double, N> alpha, theta;
+        Angles                angles;
+        bool                  valid{};
+      } cache;
+
+      if (!cache.valid || !std::equal(alpha, alpha + N, cache.alpha.begin()) || !std::equal(theta, theta + N, cache.theta.begin()))
+      {
+        std::copy(alpha, alpha + N, cache.alpha.begin());
+        std::copy(theta, theta + N, cache.theta.begin());
+        cache.angles = angles(alpha, theta);
+        cache.valid  = true;
+      }
+      return cache.angles;
+    }
+
+    template<class T = double>
+    static auto joint_sincos(const NonDeduced<JointAnglesT<T>> &q) -> JointSinCosT<T>
+    {
+      return {q.array().sin().matrix(), q.array().cos().matrix()};
+    }
+
+    template<class T, std::size_t... Is>
+    static auto getTransforms(const T *const a, const T *const d, const AnglesT<T> &angles,
+                              const JointAnglesT<T> &q, const JointSinCosT<T> &joints, std::index_sequence<Is...>) -> std::array<TransformationMatrixT<T>, N>
+    {
+      return {Links::transform(a[Is], angles.sin_alpha[Is], angles.cos_alpha[Is], d[Is], angles.sin_theta[Is], angles.cos_theta[Is],
+                               q[Is], joints.sin[Is], joints.cos[Is])...};
+    }
+
+    template<class T, std::size_t... Is>
+    static auto fk_internal(const T *const a, const T *const d, const AnglesT<T> &angles,
+                            const JointAnglesT<T> &q, const JointSinCosT<T> &joints, std::index_sequence<Is...>) -> TransformationMatrixT<T>
+    {
+      return (TransformationMatrixT<T>::Identity() *
+              ... *
+              Links::transform(a[Is], angles.sin_alpha[Is], angles.cos_alpha[Is], d[Is], angles.sin_theta[Is], angles.cos_theta[Is],
+                               q[Is], joints.sin[Is], joints.cos[Is]));
+    }
+
+    template<class T>
+    static auto fk(const T *const a, const T *const d, const AnglesT<T> &angles,
+                   const NonDeduced<JointAnglesT<T>> &q, const JointSinCosT<T> &joints) -> PositionVectorT<T>
+    {
+      KC_TELEMETRY_COUNT(FK, 1);
+      return fk_internal(a, d, angles, q, joints, std::index_sequence_for<Links...>{}).block(0, 3, 3, 1);
+    }
+
+    template<class T, std::size_t... Is>
+    static void jacobian_internal(const T *const a, const AnglesT<T> &angles, const JointSinCosT<T> &joints,
+                                  const std::array<TransformationMatrixT<T>, N + 1> &prefix,
+                                  const std::array<HomogeneousVectorT<T>, N>        &suffix,
+                                  JacobianMatrixT<T> &out, std::index_sequence<Is...>)
+    {
+      ((out.block(0, Is * 4, 3, 4) = Links::jacobian(a[Is], angles.sin_alpha[Is], angles.cos_alpha[Is], angles.sin_theta[Is], angles.cos_theta[Is],
+                                                     joints.sin[Is], joints.cos[Is], prefix[Is], suffix[Is])),
+       ...);
+    }
+
+    template<class T, std::size_t... Is>
+    static void jacobian_internal(const T *const a, const T *const alpha,
+                                  const T *const d, const T *const theta,
+                                  const JointAnglesT<T>                             &q,
+                                  const std::array<TransformationMatrixT<T>, N + 1> &prefix,
+                                  const std::array<HomogeneousVectorT<T>, N>        &suffix,
+                                  JacobianMatrixT<T> &out, std::index_sequence<Is...>)
     {
-      std::vector<TransformationMatrix> out;
-      out.reserve(N);
-      (out.push_back(Links::transform(a[Is], alpha[Is], d[Is], theta[Is], q[Is])), ...);
+      ((out.block(0, Is * 4, 3, 4) = Links::jacobian(a[Is], alpha[Is], d[Is], theta[Is], q[Is], prefix[Is], suffix[Is])), ...);
+    }
+
+    template<class T>
+    static auto jacobian(const T *const a, const T *const alpha,
+                         const T *const d, const T *const theta,
+                         const NonDeduced<JointAnglesT<T>> &q) -> JacobianMatrixT<T>
+    {
+      JacobianMatrixT<T> out;
+      fk_jacobian(a, alpha, d, theta, q, out);
       return out;
     }
+
+    // Partial products of the link transforms: prefix[i] = A_0 ... A_{i-1}, accumulated in one
+    // forward pass, and suffix[i], the origin of the end-effector in frame i (A_{i+1} ... A_e
+    // applied to [0 0 0 1]), in one backward pass.
+    template<class T>
+    struct ChainT
+    {
+      std::array<TransformationMatrixT<T>, N + 1> prefix;
+      std::array<HomogeneousVectorT<T>, N>        suffix;
+    };
+
+    using Chain = ChainT<double>;
+
+    template<class T>
+    static auto chain(const T *const a, const T *const alpha,
+                      const T *const d, const T *const theta,
+                      const NonDeduced<JointAnglesT<T>> &q) -> ChainT<T>
+    {
+      return chain(getTransforms(a, alpha, d, theta, q, std::index_sequence_for<Links...>{}));
+    }
+
+    template<class T>
+    static auto chain(const std::array<TransformationMatrixT<T>, N> &transforms) -> ChainT<T>
+    {
+      ChainT<T> out;
+      out.prefix[0] = TransformationMatrixT<T>::Identity();
+      for (std::size_t link{}; link < N; ++link)
+        out.prefix[link + 1] = out.prefix[link] * transforms[link];
+
+      out.suffix[N - 1] = HomogeneousVectorT<T>::UnitW();
+      for (std::size_t link{N - 1}; link > 0; --link)
+        out.suffix[link - 1] = transforms[link] * out.suffix[link];
+      return out;
+    }
+
+    // Forward kinematics and Jacobian sharing a single evaluation of the link transforms
+    template<class T>
+    static auto fk_jacobian(const T *const a, const T *const alpha,
+                            const T *const d, const T *const theta,
+                            const NonDeduced<JointAnglesT<T>> &q, JacobianMatrixT<T> &jacobian) -> PositionVectorT<T>
+    {
+      KC_TELEMETRY_TIME(Jacobian);
+      const ChainT<T> products = chain(a, alpha, d, theta, q);
+      jacobian_internal(a, alpha, d, theta, q, products.prefix, products.suffix, jacobian, std::index_sequence_for<Links...>{});
+      return products.prefix[N].block(0, 3, 3, 1);
+    }
+
+    template<class T>
+    static auto fk_jacobian(const T *const a, const T *const d, const AnglesT<T> &angles,
+                            const NonDeduced<JointAnglesT<T>> &q, const JointSinCosT<T> &joints, JacobianMatrixT<T> &jacobian) -> PositionVectorT<T>
+    {
+      KC_TELEMETRY_TIME(Jacobian);
+      const ChainT<T> products = chain(getTransforms(a, d, angles, q, joints, std::index_sequence_for<Links...>{}));
+      jacobian_internal(a, angles, joints, products.prefix, products.suffix, jacobian, std::index_sequence_for<Links...>{});
+      return products.prefix[N].block(0, 3, 3, 1);
+    }
+
+    template<std::size_t... Is>
+    static void joint_jacobian_internal(const std::array<TransformationMatrix, N> &prefix, const PositionVector &position,
+                                        JointJacobianMatrix &out, std::index_sequence<Is...>)
+    {
+      ((out.col(Is) = Links::is_revolute() ? PositionVector{prefix[Is].template block<3, 1>(0, 2).cross(position - prefix[Is].template block<3, 1>(0, 3))}
+                                           : PositionVector{prefix[Is].template block<3, 1>(0, 2)}),
+       ...);
+    }
+
+    // Forward kinematics and the 3 x N Jacobian d(p)/d(q) of the position with respect to the
+    // joint variables, for inverse kinematics: z_i x (p - o_i) for a revolute joint and z_i for a
+    // prismatic one, z_i and o_i being the axis and origin of prefix[i]. Only the forward products
+    // are needed.
+    static auto fk_joint_jacobian(const double *const a, const double *const d, const Angles &angles,
+                                  const JointAngles &q, const JointSinCos &joints, JointJacobianMatrix &jacobian) -> PositionVector
+    {
+      const std::array<TransformationMatrix, N> transforms = getTransforms(a, d, angles, q, joints, std::index_sequence_for<Links...>{});
+      std::array<TransformationMatrix, N>       prefix;
+      TransformationMatrix                      product = TransformationMatrix::Identity();
+      for (std::size_t link{}; link < N; ++link)
+      {
+        prefix[link] = product;
+        product      = product * transforms[link];
+      }
+
+      const PositionVector position = product.block(0, 3, 3, 1);
+      joint_jacobian_internal(prefix, position, jacobian, std::index_sequence_for<Links...>{});
+      return position;
+    }
+
+    // End-effector pose and its 6 x 4N Jacobian from the same prefix products: rows 0-2 are the
+    // position rows of fk_jacobian, rows 3-5 the rotation of the end-effector as the world-frame
+    // axis omega of dR = [omega]x R. theta turns the chain after link i about z of prefix[i] and
+    // alpha about x of prefix[i + 1] (which Rx leaves in place); a and d do not rotate it.
+    static auto fk_pose_jacobian(const double *const a, const double *const alpha,
+                                 const double *const d, const double *const theta,
+                                 const JointAngles &q, PoseJacobianMatrix &jacobian) -> TransformationMatrix
+    {
+      KC_TELEMETRY_TIME(Jacobian);
+      const Chain    products = chain(a, alpha, d, theta, q);
+      JacobianMatrix position;
+      jacobian_internal(a, alpha, d, theta, q, products.prefix, products.suffix, position, std::index_sequence_for<Links...>{});
+      return pose_jacobian(products, position, jacobian);
+    }
+
+    static auto fk_pose(const double *const a, const double *const d, const Angles &angles,
+                        const JointAngles &q, const JointSinCos &joints) -> TransformationMatrix
+    {
+      KC_TELEMETRY_COUNT(FK, 1);
+      return fk_internal(a, d, angles, q, joints, std::index_sequence_for<Links...>{});
+    }
+
+    static auto fk_pose_jacobian(const double *const a, const double *const d, const Angles &angles,
+                                 const JointAngles &q, const JointSinCos &joints, PoseJacobianMatrix &jacobian) -> TransformationMatrix
+    {
+      KC_TELEMETRY_TIME(Jacobian);
+      const Chain    products = chain(getTransforms(a, d, angles, q, joints, std::index_sequence_for<Links...>{}));
+      JacobianMatrix position;
+      jacobian_internal(a, angles, joints, products.prefix, products.suffix, position, std::index_sequence_for<Links...>{});
+      return pose_jacobian(products, position, jacobian);
+    }
+
+    static auto pose_jacobian(const Chain &products, const JacobianMatrix &position, PoseJacobianMatrix &jacobian) -> TransformationMatrix
+    {
+      jacobian.topRows(3) = position;
+      for (std::size_t link{}; link < N; ++link)
+      {
+        jacobian.block(3, 4 * link + 0, 3, 1).setZero();
+        jacobian.block(3, 4 * link + 1, 3, 1) = products.prefix[link + 1].block(0, 0, 3, 1);
+        jacobian.block(3, 4 * link + 2, 3, 1).setZero();
+        jacobian.block(3, 4 * link + 3, 3, 1) = products.prefix[link].block(0, 2, 3, 1);
+      }
+      return products.prefix[N];
+    }
+
+    template<class T, std::size_t... Is>
+    static auto getTransforms(const T *const a, const T *const alpha,
+                              const T *const d, const T *const theta,
+                              const JointAnglesT<T> &q, std::index_sequence<Is...>) -> std::array<TransformationMatrixT<T>, N>
+    {
+      return {Links::transform(a[Is], alpha[Is], d[Is], theta[Is], q[Is])...};
+    }
   };
 
 } // namespace kc
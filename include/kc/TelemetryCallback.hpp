@@ -0,0 +1,72 @@
+#ifndef KC_TELEMETRYCALLBACK_HPP_
+#define KC_TELEMETRYCALLBACK_HPP_
+
+#include <iomanip>
+#include <limits>
+#include <ostream>
+
+#include "kc/telemetry.hpp"
+
+#include "ceres/ceres.h"
+
+namespace kc
+{
+  // Writes one JSON line per solver iteration: the Ceres iteration summary (its
+  // step_solver_time_in_seconds being the linear solver time) and, if instrumented, the counts
+  // and probe timings accumulated since the previous line. Counts are process-wide, so solves
+  // running concurrently are attributed together. Doubles are written with max_digits10, so that
+  // they read back exactly, as in kc::write_result.
+  struct TelemetryCallback : public ceres::IterationCallback
+  {
+    explicit TelemetryCallback(std::ostream &out) : out_{out}, last_{telemetry::snapshot()} {}
+
+    auto operator()(const ceres::IterationSummary &summary) -> ceres::CallbackReturnType override
+    {
+      const telemetry::Snapshot now   = telemetry::snapshot();
+      const telemetry::Snapshot delta = now - this->last_;
+      this->last_                     = now;
+
+      this->out_ << std::setprecision(std::numeric_limits<double>::max_digits10)
+                 << "{\"iteration\": " << summary.iteration
+                 << ", \"cost\": " << summary.cost
+                 << ", \"cost_change\": " << summary.cost_change
+                 << ", \"gradient_max_norm\": " << summary.gradient_max_norm
+                 << ", \"step_norm\": " << summary.step_norm
+                 << ", \"trust_region_radius\": " << summary.trust_region_radius
+                 << ", \"step_is_successful\": " << (summary.step_is_successful ? "true" : "false")
+                 << ", \"linear_solver_iterations\": " << summary.linear_solver_iterations
+                 << ", \"iteration_seconds\": " << summary.iteration_time_in_seconds
+                 << ", \"linear_solver_seconds\": " << summary.step_solver_time_in_seconds
+                 << ", \"cumulative_seconds\": " << summary.cumulative_time_in_seconds;
+      if (telemetry::enabled())
+      {
+        this->out_ << ", \"fk\": " << delta[telemetry::Counter::FK]
+                   << ", \"fk_batch\": " << delta[telemetry::Counter::FKBatch]
+                   << ", \"fk_batch_samples\": " << delta[telemetry::Counter::FKBatchSamples]
+                   << ", \"allocations\": " << delta[telemetry::Counter::Allocations];
+        write(", \"evaluate\": ", delta[telemetry::Probe::Evaluate]);
+        write(", \"jacobian\": ", delta[telemetry::Probe::Jacobian]);
+      }
+      this->out_ << "}\n";
+      this->out_.flush();
+      return ceres::SOLVER_CONTINUE;
+    }
+
+  private:
+    void write(const char *const key, const telemetry::ProbeSnapshot &probe)
+    {
+      std::size_t used{telemetry::buckets};
+      while (used > 0 && probe.histogram[used - 1] == 0)
+        --used;
+      this->out_ << key << "{\"calls\": " << probe.calls << ", \"seconds\": " << double(probe.nanoseconds) * 1e-9 << ", \"log2_ns_histogram\": [";
+      for (std::size_t b{}; b < used; ++b)
+        this->out_ << (b > 0 ? ", " : "") << probe.histogram[b];
+      this->out_ << "]}";
+    }
+
+    std::ostream       &out_;
+    telemetry::Snapshot last_;
+  };
+} // namespace kc
+
+#endif // KC_TELEMETRYCALLBACK_HPP_
@@ -0,0 +1,145 @@
+#ifndef KC_THREADPOOL_HPP_
+#define KC_THREADPOOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kc
+{
+  // Work-stealing thread pool. Submitted tasks are dealt round-robin to per-worker queues; a
+  // worker runs its own queue newest first and, once it is empty, steals the oldest task of the
+  // other queues, so long tasks dealt to one worker do not hold back the rest. A task that throws
+  // is counted in failed() and its exception dropped, so that it takes neither the worker nor the
+  // process down.
+  struct ThreadPool
+  {
+    explicit ThreadPool(const std::size_t threads)
+    {
+      const std::size_t count = std::max<std::size_t>(1, threads);
+      for (std::size_t i{}; i < count; ++i)
+        this->queues_.push_back(std::make_unique<Queue>());
+      for (std::size_t i{}; i < count; ++i)
+        this->workers_.emplace_back([this, i] { this->work(i); });
+    }
+
+    ThreadPool(const ThreadPool &)            = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock{this->mutex_};
+        this->stop_ = true;
+      }
+      this->wake_.notify_all();
+      for (auto &worker : this->workers_)
+        worker.join();
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return this->workers_.size(); }
+
+    void submit(std::function<void()> task)
+    {
+      Queue &queue = *this->queues_[this->next_.fetch_add(1, std::memory_order_relaxed) % this->queues_.size()];
+      {
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        queue.tasks.push_back(std::move(task));
+      }
+      {
+        std::lock_guard<std::mutex> lock{this->mutex_};
+        ++this->queued_;
+        ++this->pending_;
+      }
+      this->wake_.notify_one();
+    }
+
+    // Blocks until every submitted task has completed
+    void wait()
+    {
+      std::unique_lock<std::mutex> lock{this->mutex_};
+      this->idle_.wait(lock, [this] { return this->pending_ == 0; });
+    }
+
+    // Tasks that ended with an exception so far
+    [[nodiscard]] auto failed() -> std::size_t
+    {
+      std::lock_guard<std::mutex> lock{this->mutex_};
+      return this->failed_;
+    }
+
+  private:
+    struct Queue
+    {
+      std::mutex                        mutex;
+      std::deque<std::function<void()>> tasks;
+    };
+
+    // Takes the newest task of queue self or, failing that, the oldest task of another queue
+    auto take(const std::size_t self) -> std::function<void()>
+    {
+      for (std::size_t offset{};; offset = (offset + 1) % this->queues_.size())
+      {
+        Queue                      &queue = *this->queues_[(self + offset) % this->queues_.size()];
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        if (queue.tasks.empty()) continue;
+        std::function<void()> task;
+        if (offset == 0)
+        {
+          task = std::move(queue.tasks.back());
+          queue.tasks.pop_back();
+        }
+        else
+        {
+          task = std::move(queue.tasks.front());
+          queue.tasks.pop_front();
+        }
+        return task;
+      }
+    }
+
+    void work(const std::size_t self)
+    {
+      for (;;)
+      {
+        {
+          // Claiming one of the queued_ tasks guarantees take() finds it in some queue
+          std::unique_lock<std::mutex> lock{this->mutex_};
+          this->wake_.wait(lock, [this] { return this->stop_ || this->queued_ > 0; });
+          if (this->queued_ == 0) return;
+          --this->queued_;
+        }
+
+        bool failed{};
+        try
+        {
+          this->take(self)();
+        }
+        catch (...)
+        {
+          failed = true;
+        }
+
+        std::lock_guard<std::mutex> lock{this->mutex_};
+        this->failed_ += failed ? 1 : 0;
+        if (--this->pending_ == 0) this->idle_.notify_all();
+      }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread>            workers_;
+    std::atomic<std::size_t>            next_{};
+    std::mutex                          mutex_;
+    std::condition_variable             wake_, idle_;
+    std::size_t                         queued_{}, pending_{}, failed_{};
+    bool                                stop_{};
+  };
+} // namespace kc
+
+#endif // KC_THREADPOOL_HPP_
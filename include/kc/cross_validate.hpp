@@ -0,0 +1,73 @@
+#ifndef KC_CROSS_VALIDATE_HPP_
+#define KC_CROSS_VALIDATE_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "kc/Calibrator.hpp"
+#include "kc/evaluate.hpp"
+#include "kc/io.hpp"
+#include "kc/parallel.hpp"
+
+#include "ceres/ceres.h"
+
+namespace kc
+{
+  struct CrossValidation
+  {
+    std::vector<Evaluation>             folds;
+    std::vector<std::vector<double>>    parameters; // a, alpha, d, theta fitted without each fold, back to back
+    std::vector<ceres::Solver::Summary> summaries;
+    double                              rmse{}; // pooled over every held-out sample
+  };
+
+  // k-fold cross-validation over contiguous folds of the dataset: for every fold the problem is
+  // solved from the initial a, alpha, d, theta on the remaining samples and evaluated on the
+  // fold. Folds run concurrently, the threads of calibration.num_threads being shared among them.
+  template<class Robot, std::size_t B = 64>
+  [[nodiscard]] auto cross_validate(const double *const a, const double *const alpha,
+                                    const double *const d, const double *const theta,
+                                    const ColumnsView<Robot::N> &joint_angles, const ColumnsView<3> &xyz,
+                                    const std::size_t k, CalibrationOptions calibration = {},
+                                    const EvaluationOptions &evaluation = {}) -> CrossValidation
+  {
+    constexpr std::size_t N = Robot::N;
+
+    const std::size_t fold_threads = std::min<std::size_t>(k, std::size_t(std::max(1, calibration.num_threads)));
+    calibration.num_threads        = std::max(1, calibration.num_threads / int(std::max<std::size_t>(1, fold_threads)));
+
+    EvaluationOptions fold_evaluation = evaluation;
+    fold_evaluation.num_threads       = std::size_t(calibration.num_threads);
+
+    CrossValidation out;
+    out.folds.resize(k);
+    out.parameters.assign(k, std::vector<double>(4 * N));
+    out.summaries.resize(k);
+
+    const std::size_t samples = xyz.rows();
+    parallel_for(k, fold_threads, [&](const std::size_t fold) {
+      const std::size_t begin = samples * fold / k, end = samples * (fold + 1) / k;
+
+      double *const parameters = out.parameters[fold].data();
+      std::copy_n(a, N, parameters);
+      std::copy_n(alpha, N, parameters + N);
+      std::copy_n(d, N, parameters + 2 * N);
+      std::copy_n(theta, N, parameters + 3 * N);
+
+      Calibrator<Robot, B> calibrator(joint_angles, xyz, {{0, begin}, {end, samples}},
+                                      parameters, parameters + N, parameters + 2 * N, parameters + 3 * N, calibration);
+      out.summaries[fold] = calibrator.solve();
+      out.folds[fold]     = evaluate<Robot>(parameters, parameters + N, parameters + 2 * N, parameters + 3 * N,
+                                            joint_angles, xyz, begin, end, fold_evaluation);
+    });
+
+    double squared{};
+    for (const Evaluation &fold : out.folds)
+      squared += fold.rmse * fold.rmse * double(fold.samples);
+    out.rmse = samples > 0 ? std::sqrt(squared / double(samples)) : 0.;
+    return out;
+  }
+} // namespace kc
+
+#endif // KC_CROSS_VALIDATE_HPP_
@@ -0,0 +1,221 @@
+#ifndef KC_EVALUATE_HPP_
+#define KC_EVALUATE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "kc/Robot.hpp"
+#include "kc/io.hpp"
+#include "kc/parallel.hpp"
+
+#include "Eigen/Dense"
+
+namespace kc
+{
+  struct EvaluationOptions
+  {
+    std::size_t num_threads{default_threads()};
+    std::size_t bins{20}; // histogram bins spanning [0, max]
+    Precision   precision{Precision::Double};
+    double      single_precision_tolerance{0.05}; // Mixed: largest float rounding bound, relative to the RMSE
+  };
+
+  // Statistics of the position error |fk(q) - p| over a set of samples
+  struct Evaluation
+  {
+    std::size_t              samples{};
+    double                   rmse{};
+    double                   mean{};
+    double                   max{};
+    std::size_t              argmax{}; // sample index of max
+    double                   p50{}, p90{}, p95{}, p99{};
+    Eigen::Vector3d          bias{Eigen::Vector3d::Zero()};      // mean signed error per axis
+    Eigen::Vector3d          axis_rmse{Eigen::Vector3d::Zero()}; // per-axis RMSE
+    std::vector<std::size_t> histogram; // counts of the error over bins of width max / bins
+    Precision                precision{Precision::Double}; // Mixed if the forward kinematics ran in float
+  };
+
+  namespace detail
+  {
+    // Samples per chunk of the parallel evaluation. Partial sums are taken per chunk and reduced
+    // in chunk order, so the results do not depend on the number of threads.
+    inline constexpr std::size_t evaluation_chunk = 4096;
+
+    struct EvaluationPartial
+    {
+      double          squared{}, norm{}, max{}, squared_reach{};
+      std::size_t     argmax{};
+      Eigen::Vector3d sum{Eigen::Vector3d::Zero()}, sum_squared{Eigen::Vector3d::Zero()};
+    };
+
+    // Nearest-rank percentile p in [0, 1] of a non-empty set of values, which are reordered
+    [[nodiscard]] inline auto percentile(std::vector<double> &values, const double p) -> double
+    {
+      const std::size_t nearest = std::size_t(std::ceil(p * double(values.size())));
+      const std::size_t rank    = std::min(values.size() - 1, nearest > 0 ? nearest - 1 : 0);
+      std::nth_element(values.begin(), values.begin() + std::ptrdiff_t(rank), values.end());
+      return values[rank];
+    }
+
+    // Bound on the position error of float forward kinematics: every link adds a few float
+    // rounding errors relative to the reach, taken as the sum of the link lengths or the farthest
+    // measured position (prismatic joints extending the chain), whichever is larger.
+    template<class Robot>
+    [[nodiscard]] auto single_precision_bound(const double *const a, const double *const d, const double measured_reach) -> double
+    {
+      double reach{};
+      for (std::size_t link{}; link < Robot::N; ++link)
+        reach += std::abs(a[link]) + std::abs(d[link]);
+      return 2. * double(Robot::N) * FLT_EPSILON * std::max(reach, measured_reach);
+    }
+  } // namespace detail
+
+  // Evaluates the DH parameters a, alpha, d, theta on samples [begin, end) of a dataset. Forward
+  // kinematics runs lane-wise (Robot::fk_batch) over chunks of samples spread across
+  // options.num_threads threads; the error statistics are gathered in the same pass. With
+  // Precision::Mixed it runs in float, unless the float rounding bound exceeds
+  // options.single_precision_tolerance times the resulting RMSE, in which case the evaluation is
+  // repeated in double: the errors then shift by less than that fraction of the RMSE.
+  template<class Robot>
+  [[nodiscard]] auto evaluate(const double *const a, const double *const alpha,
+                              const double *const d, const double *const theta,
+                              const ColumnsView<Robot::N> &joint_angles, const ColumnsView<3> &xyz,
+                              const std::size_t begin, const std::size_t end,
+                              const EvaluationOptions &options = {}) -> Evaluation
+  {
+    constexpr std::size_t Chunk = detail::evaluation_chunk;
+
+    Evaluation out;
+    out.samples = end - begin;
+    out.histogram.assign(options.bins, 0);
+    if (out.samples == 0) return out;
+
+    const bool                             single = options.precision == Precision::Mixed;
+    const std::size_t                      chunks = (out.samples + Chunk - 1) / Chunk;
+    std::vector<detail::EvaluationPartial> partials(chunks);
+    std::vector<double>                    errors(out.samples);
+
+    parallel_for(chunks, options.num_threads, [&](const std::size_t chunk) {
+      const std::size_t first = begin + chunk * Chunk;
+      const std::size_t count = std::min(Chunk, end - first);
+
+      double predicted[3][Chunk];
+      if (single)
+        Robot::template fk_batch<double, float>(a, alpha, d, theta, joint_angles.data() + first, joint_angles.rows(), count, &predicted[0][0], Chunk);
+      else
+        Robot::fk_batch(a, alpha, d, theta, joint_angles.data() + first, joint_angles.rows(), count, &predicted[0][0], Chunk);
+
+      detail::EvaluationPartial &partial = partials[chunk];
+      if (single)
+        for (std::size_t i{first}; i < first + count; ++i)
+          partial.squared_reach = std::max(partial.squared_reach, xyz.column(0)[i] * xyz.column(0)[i] +
+                                                                    xyz.column(1)[i] * xyz.column(1)[i] +
+                                                                    xyz.column(2)[i] * xyz.column(2)[i]);
+      for (std::size_t i{}; i < count; ++i)
+      {
+        const Eigen::Vector3d error{predicted[0][i] - xyz.column(0)[first + i],
+                                    predicted[1][i] - xyz.column(1)[first + i],
+                                    predicted[2][i] - xyz.column(2)[first + i]};
+        const double          norm = error.norm();
+        errors[first - begin + i]  = norm;
+        partial.squared += norm * norm;
+        partial.norm += norm;
+        partial.sum += error;
+        partial.sum_squared += error.cwiseAbs2();
+        if (norm > partial.max)
+        {
+          partial.max    = norm;
+          partial.argmax = first + i;
+        }
+      }
+    });
+
+    detail::EvaluationPartial total;
+    total.argmax = begin;
+    for (const auto &partial : partials)
+    {
+      total.squared += partial.squared;
+      total.norm += partial.norm;
+      total.sum += partial.sum;
+      total.sum_squared += partial.sum_squared;
+      total.squared_reach = std::max(total.squared_reach, partial.squared_reach);
+      if (partial.max > total.max)
+      {
+        total.max    = partial.max;
+        total.argmax = partial.argmax;
+      }
+    }
+
+    const double n = double(out.samples);
+    out.rmse       = std::sqrt(total.squared / n);
+    out.mean       = total.norm / n;
+    out.max        = total.max;
+    out.argmax     = total.argmax;
+    out.bias       = total.sum / n;
+    out.axis_rmse  = (total.sum_squared / n).cwiseSqrt();
+
+    if (single)
+    {
+      if (detail::single_precision_bound<Robot>(a, d, std::sqrt(total.squared_reach)) > options.single_precision_tolerance * out.rmse)
+      {
+        EvaluationOptions exact = options;
+        exact.precision         = Precision::Double;
+        return evaluate<Robot>(a, alpha, d, theta, joint_angles, xyz, begin, end, exact);
+      }
+      out.precision = Precision::Mixed;
+    }
+
+    if (options.bins > 0 && out.max == 0.)
+      out.histogram[0] = out.samples;
+    else if (options.bins > 0)
+    {
+      std::vector<std::vector<std::size_t>> counts(chunks, std::vector<std::size_t>(options.bins, 0));
+      parallel_for(chunks, options.num_threads, [&](const std::size_t chunk) {
+        const std::size_t last = std::min(out.samples, (chunk + 1) * Chunk);
+        for (std::size_t i{chunk * Chunk}; i < last; ++i)
+          ++counts[chunk][std::min(options.bins - 1, std::size_t(errors[i] / out.max * double(options.bins)))];
+      });
+      for (const auto &chunk : counts)
+        for (std::size_t bin{}; bin < options.bins; ++bin)
+          out.histogram[bin] += chunk[bin];
+    }
+
+    out.p50 = detail::percentile(errors, 0.50);
+    out.p90 = detail::percentile(errors, 0.90);
+    out.p95 = detail::percentile(errors, 0.95);
+    out.p99 = detail::percentile(errors, 0.99);
+    return out;
+  }
+
+  inline void report(const Evaluation &evaluation)
+  {
+    if (evaluation.samples == 0)
+    {
+      std::cout << "No validation samples\n";
+      return;
+    }
+    std::cout << std::fixed << std::setprecision(6)
+              << "Validation samples:  " << evaluation.samples << "\n"
+              << "RMSE [m]:            " << evaluation.rmse << "\n"
+              << "Mean [m]:            " << evaluation.mean << "\n"
+              << "Max [m]:             " << evaluation.max << " (sample " << evaluation.argmax << ")\n"
+              << "p50/p90/p95/p99 [m]: " << evaluation.p50 << " " << evaluation.p90 << " " << evaluation.p95 << " " << evaluation.p99 << "\n"
+              << "Bias x/y/z [m]:      " << evaluation.bias.x() << " " << evaluation.bias.y() << " " << evaluation.bias.z() << "\n"
+              << "RMSE x/y/z [m]:      " << evaluation.axis_rmse.x() << " " << evaluation.axis_rmse.y() << " " << evaluation.axis_rmse.z() << "\n";
+
+    if (evaluation.histogram.empty()) return;
+    const std::size_t peak  = *std::max_element(evaluation.histogram.begin(), evaluation.histogram.end());
+    const double      width = evaluation.max / double(std::max<std::size_t>(1, evaluation.histogram.size()));
+    for (std::size_t bin{}; bin < evaluation.histogram.size(); ++bin)
+      std::cout << std::right << std::fixed << std::setprecision(6) << std::setw(10) << double(bin + 1) * width
+                << std::right << std::setw(9) << evaluation.histogram[bin] << " "
+                << std::string(peak > 0 ? evaluation.histogram[bin] * 50 / peak : 0, '#') << "\n";
+  }
+} // namespace kc
+
+#endif // KC_EVALUATE_HPP_
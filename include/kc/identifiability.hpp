@@ -0,0 +1,116 @@
+#ifndef KC_IDENTIFIABILITY_HPP_
+#define KC_IDENTIFIABILITY_HPP_
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "kc/Robot.hpp"
+#include "kc/io.hpp"
+
+#include "Eigen/Dense"
+
+namespace kc
+{
+  struct IdentifiabilityOptions
+  {
+    std::size_t poses{1000};     // poses spread evenly over the samples
+    double      tolerance{1e-6}; // relative to the largest (column-scaled) diagonal of R
+  };
+
+  struct Identifiability
+  {
+    std::size_t                     parameters{}, rank{}, poses{};
+    std::array<std::vector<int>, 4> fixed;           // indices of a, alpha, d, theta to hold constant
+    Eigen::VectorXd                 singular_values; // of the column-scaled stacked Jacobian, descending
+
+    // Condition number of the identifiable directions
+    [[nodiscard]] auto condition_number() const -> double
+    {
+      return this->rank > 0 ? this->singular_values[0] / this->singular_values[Eigen::Index(this->rank) - 1] : 0.;
+    }
+  };
+
+  // Identifiability of the DH parameters of Robot at a, alpha, d, theta from samples in ranges.
+  // The Jacobians of the poses are stacked and their columns scaled to unit norm, so that lengths
+  // and angles compare; parameters whose column vanishes are unidentifiable, and a QR decomposition
+  // with column pivoting orders the others from the most to the least independent. The columns
+  // past the numerical rank are combinations of the ones before them (e.g. the d of consecutive
+  // parallel axes) and are marked fixed, so that the remaining parameters absorb their effect.
+  template<class Robot>
+  [[nodiscard]] auto identifiability(const double *const a, const double *const alpha,
+                                     const double *const d, const double *const theta,
+                                     const ColumnsView<Robot::N> &joint_angles, const std::vector<SampleRange> &ranges,
+                                     const IdentifiabilityOptions &options = {}) -> Identifiability
+  {
+    constexpr std::size_t P = 4 * Robot::N;
+
+    Identifiability out;
+    out.parameters = P;
+
+    std::size_t samples{};
+    for (const auto &[begin, end] : ranges)
+      samples += end - begin;
+    out.poses = std::min(options.poses, samples);
+    if (out.poses == 0) return out;
+
+    // Pose k is the (k samples / poses)-th sample of the ranges
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> jacobian(3 * out.poses, P);
+    auto                                                  range = ranges.begin();
+    std::size_t                                           skipped{};
+    for (std::size_t k{}; k < out.poses; ++k)
+    {
+      const std::size_t sample = k * samples / out.poses;
+      while (sample - skipped >= range->second - range->first)
+      {
+        skipped += range->second - range->first;
+        ++range;
+      }
+      jacobian.middleRows<3>(Eigen::Index(3 * k)) = Robot::jacobian(a, alpha, d, theta, joint_angles.row(range->first + sample - skipped));
+    }
+
+    const Eigen::RowVectorXd norms = jacobian.colwise().norm();
+    const double             limit = options.tolerance * norms.maxCoeff();
+    for (Eigen::Index col{}; col < Eigen::Index(P); ++col)
+      if (norms[col] > limit)
+        jacobian.col(col) /= norms[col];
+      else
+        jacobian.col(col).setZero();
+
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(jacobian);
+    qr.setThreshold(options.tolerance);
+    out.rank = std::size_t(qr.rank());
+    for (Eigen::Index i{Eigen::Index(out.rank)}; i < Eigen::Index(P); ++i)
+    {
+      const int col = qr.colsPermutation().indices()[i];
+      out.fixed[std::size_t(col % 4)].push_back(col / 4);
+    }
+    for (std::vector<int> &block : out.fixed)
+      std::sort(block.begin(), block.end());
+
+    // R has the singular values of the scaled Jacobian. Fewer than 4N / 3 poses leave R with
+    // fewer rows than parameters, and the rank at most that many.
+    const Eigen::MatrixXd R = qr.matrixR().topRows(std::min<Eigen::Index>(qr.matrixR().rows(), Eigen::Index(P))).template triangularView<Eigen::Upper>();
+    out.singular_values     = Eigen::JacobiSVD<Eigen::MatrixXd>(R).singularValues();
+    return out;
+  }
+
+  inline void report(const Identifiability &identifiability)
+  {
+    constexpr const char *names[] = {"a", "alpha", "d", "theta"};
+
+    std::cout << std::fixed << std::setprecision(6)
+              << "Analysed poses:      " << identifiability.poses << "\n"
+              << "Rank:                " << identifiability.rank << " / " << identifiability.parameters << "\n"
+              << "Condition number:    " << std::scientific << identifiability.condition_number() << std::fixed << "\n"
+              << "Fixed parameters:   ";
+    for (std::size_t block{}; block < 4; ++block)
+      for (const int link : identifiability.fixed[block])
+        std::cout << " " << names[block] << link + 1;
+    std::cout << "\n";
+  }
+} // namespace kc
+
+#endif // KC_IDENTIFIABILITY_HPP_
@@ -0,0 +1,266 @@
+#ifndef KC_IO_HPP_
+#define KC_IO_HPP_
+
+#include <algorithm>
+#include <charconv>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "kc/parallel.hpp"
+#include "kc/types.hpp"
+
+#include "Eigen/Dense"
+
+namespace kc
+{
+  // Non-owning view of C columns of doubles stored one after the other (column c of row r at
+  // data[c * rows + r]), which is both the structure-of-arrays layout of Robot::fk_batch and
+  // Eigen's column-major one.
+  template<std::size_t C>
+  struct ColumnsView
+  {
+    static constexpr std::size_t Cols = C;
+
+    ColumnsView() = default;
+    ColumnsView(const double *const data, const std::size_t rows) : data_{data}, rows_{rows} {}
+
+    [[nodiscard]] auto rows() const -> std::size_t { return this->rows_; }
+    [[nodiscard]] auto data() const -> const double * { return this->data_; }
+    [[nodiscard]] auto column(const std::size_t c) const -> const double * { return this->data_ + c * this->rows_; }
+    [[nodiscard]] auto row(const std::size_t r) const -> Vector<C>
+    {
+      Vector<C> out;
+      for (std::size_t c{}; c < C; ++c)
+        out[c] = this->data_[c * this->rows_ + r];
+      return out;
+    }
+    [[nodiscard]] auto matrix() const -> Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, C>>
+    {
+      return {this->data_, Eigen::Index(this->rows_), Eigen::Index(C)};
+    }
+
+  private:
+    const double *data_{};
+    std::size_t   rows_{};
+  };
+
+  // Owning storage with the layout of ColumnsView, filled by kc::load_columns.
+  template<std::size_t C>
+  struct Columns
+  {
+    static constexpr std::size_t Cols = C;
+
+    [[nodiscard]] auto view() const -> ColumnsView<C> { return {this->data_.data(), this->rows_}; }
+    operator ColumnsView<C>() const { return this->view(); }
+
+    [[nodiscard]] auto rows() const -> std::size_t { return this->rows_; }
+    [[nodiscard]] auto data() const -> const double * { return this->data_.data(); }
+    [[nodiscard]] auto column(const std::size_t c) const -> const double * { return this->view().column(c); }
+    [[nodiscard]] auto row(const std::size_t r) const -> Vector<C> { return this->view().row(r); }
+    [[nodiscard]] auto matrix() const -> Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, C>> { return this->view().matrix(); }
+
+    void resize(const std::size_t rows)
+    {
+      this->rows_ = rows;
+      this->data_.resize(rows * C);
+    }
+    [[nodiscard]] auto data() -> double * { return this->data_.data(); }
+
+  private:
+    std::size_t         rows_{};
+    std::vector<double> data_;
+  };
+
+  // Half-open range [first, second) of sample indices
+  using SampleRange = std::pair<std::size_t, std::size_t>;
+
+  // Copies the given rows of in, in that order, e.g. a subset of samples picked by kc::select_samples
+  template<std::size_t C>
+  [[nodiscard]] auto gather(const ColumnsView<C> &in, const std::vector<std::size_t> &rows) -> Columns<C>
+  {
+    Columns<C> out;
+    out.resize(rows.size());
+    for (std::size_t c{}; c < C; ++c)
+      for (std::size_t r{}; r < rows.size(); ++r)
+        out.data()[c * rows.size() + r] = in.column(c)[rows[r]];
+    return out;
+  }
+
+  enum class LoadError
+  {
+    None,
+    Open,
+    Map,
+    Parse,
+    Mismatch,
+    Format,
+    Checksum,
+    Write
+  };
+
+  struct LoadStatus
+  {
+    LoadError   error{LoadError::None};
+    std::size_t row{}; // 1-based index of the offending non-blank line for LoadError::Parse
+    std::string message;
+
+    explicit operator bool() const { return this->error == LoadError::None; }
+  };
+
+  namespace detail
+  {
+    // Read-only private mapping of a whole file; data is nullptr for an empty file.
+    struct MappedFile
+    {
+      MappedFile() = default;
+      MappedFile(const MappedFile &)            = delete;
+      MappedFile &operator=(const MappedFile &) = delete;
+      ~MappedFile()
+      {
+        if (this->data != nullptr) ::munmap(const_cast<char *>(this->data), this->size);
+        if (this->fd >= 0) ::close(this->fd);
+      }
+
+      [[nodiscard]] auto open(const std::string &filename) -> LoadStatus
+      {
+        this->fd = ::open(filename.c_str(), O_RDONLY);
+        if (this->fd < 0) return {LoadError::Open, 0, "Could not open file " + filename};
+
+        struct stat info;
+        if (::fstat(this->fd, &info) != 0) return {LoadError::Open, 0, "Could not stat file " + filename};
+        this->size = static_cast<std::size_t>(info.st_size);
+        if (this->size == 0) return {};
+
+        void *address = ::mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, this->fd, 0);
+        if (address == MAP_FAILED) return {LoadError::Map, 0, "Could not map file " + filename};
+        this->data = static_cast<const char *>(address);
+        ::madvise(address, this->size, MADV_WILLNEED);
+        return {};
+      }
+
+      const char *data{};
+      std::size_t size{};
+      int         fd{-1};
+    };
+
+    [[nodiscard]] inline auto is_blank(const char c) -> bool { return c == ' ' || c == '\t' || c == '\r'; }
+
+    [[nodiscard]] inline auto skip_blanks(const char *first, const char *const last) -> const char *
+    {
+      while (first != last && is_blank(*first)) ++first;
+      return first;
+    }
+
+    [[nodiscard]] inline auto line_end(const char *const first, const char *const last) -> const char *
+    {
+      return std::find(first, last, '\n');
+    }
+
+    // Number of lines in [first, last) holding at least one non-blank character
+    [[nodiscard]] inline auto count_rows(const char *first, const char *const last) -> std::size_t
+    {
+      std::size_t rows{};
+      while (first != last)
+      {
+        const char *const end = line_end(first, last);
+        if (skip_blanks(first, end) != end) ++rows;
+        first = (end == last) ? last : end + 1;
+      }
+      return rows;
+    }
+
+    // Parses the non-blank lines of [first, last) into rows [row, ...) of columns spaced stride
+    // apart. Returns the number of rows parsed before the first malformed line, if any.
+    template<std::size_t C>
+    [[nodiscard]] auto parse_rows(const char *first, const char *const last,
+                                  double *const data, const std::size_t stride, const std::size_t row) -> std::size_t
+    {
+      std::size_t parsed{};
+      while (first != last)
+      {
+        const char *const end = line_end(first, last);
+        const char       *ptr = skip_blanks(first, end);
+        first                 = (end == last) ? last : end + 1;
+        if (ptr == end) continue;
+
+        for (std::size_t c{}; c < C; ++c)
+        {
+          const auto [next, ec] = std::from_chars(ptr, end, data[c * stride + row + parsed]);
+          if (ec != std::errc{} || (next != end && !is_blank(*next))) return parsed;
+          ptr = skip_blanks(next, end);
+        }
+        if (ptr != end) return parsed;
+        ++parsed;
+      }
+      return parsed;
+    }
+  } // namespace detail
+
+  // Loads a whitespace-separated text file with C values per line (e.g. data/P_KUKA.txt) into
+  // out. The file is memory-mapped, split into num_threads line-aligned chunks and each chunk is
+  // parsed with std::from_chars straight into its rows of out; blank lines are ignored.
+  template<std::size_t C>
+  [[nodiscard]] auto load_columns(const std::string &filename, Columns<C> &out,
+                                  std::size_t num_threads = std::thread::hardware_concurrency()) -> LoadStatus
+  {
+    detail::MappedFile file;
+    if (LoadStatus status = file.open(filename); !status) return status;
+
+    const char *const begin = file.data;
+    const char *const end   = file.data + file.size;
+
+    num_threads = std::clamp<std::size_t>(num_threads, 1, std::max<std::size_t>(1, file.size / 4096));
+    std::vector<const char *> bounds(num_threads + 1, end);
+    bounds[0] = begin;
+    for (std::size_t chunk{1}; chunk < num_threads; ++chunk)
+    {
+      const char *const split = std::max(bounds[chunk - 1], begin + file.size * chunk / num_threads);
+      const char *const eol   = detail::line_end(split, end);
+      bounds[chunk]           = (eol == end) ? end : eol + 1;
+    }
+
+    std::vector<std::size_t> first_row(num_threads + 1, 0);
+    std::vector<std::size_t> parsed(num_threads, 0);
+
+    parallel_for(num_threads, num_threads, [&](const std::size_t chunk) { first_row[chunk + 1] = detail::count_rows(bounds[chunk], bounds[chunk + 1]); });
+    for (std::size_t chunk{}; chunk < num_threads; ++chunk)
+      first_row[chunk + 1] += first_row[chunk];
+
+    out.resize(first_row[num_threads]);
+    double *const data = out.data();
+    parallel_for(num_threads, num_threads, [&](const std::size_t chunk) { parsed[chunk] = detail::parse_rows<C>(bounds[chunk], bounds[chunk + 1], data, out.rows(), first_row[chunk]); });
+
+    for (std::size_t chunk{}; chunk < num_threads; ++chunk)
+      if (first_row[chunk] + parsed[chunk] != first_row[chunk + 1])
+      {
+        const std::size_t row = first_row[chunk] + parsed[chunk] + 1;
+        out.resize(0);
+        return {LoadError::Parse, row, filename + ": expected " + std::to_string(C) + " numbers on data row " + std::to_string(row)};
+      }
+    return {};
+  }
+
+  // Loads a pair of joint angle / measured position files, checking that they hold the same
+  // number of samples.
+  template<std::size_t N>
+  [[nodiscard]] auto load_samples(const std::string &q_filename, const std::string &xyz_filename,
+                                  Columns<N> &joint_angles, Columns<3> &xyz,
+                                  const std::size_t num_threads = std::thread::hardware_concurrency()) -> LoadStatus
+  {
+    if (LoadStatus status = load_columns(q_filename, joint_angles, num_threads); !status) return status;
+    if (LoadStatus status = load_columns(xyz_filename, xyz, num_threads); !status) return status;
+    if (joint_angles.rows() != xyz.rows())
+      return {LoadError::Mismatch, 0, q_filename + " holds " + std::to_string(joint_angles.rows()) + " samples but " + xyz_filename + " holds " + std::to_string(xyz.rows())};
+    return {};
+  }
+} // namespace kc
+
+#endif // KC_IO_HPP_
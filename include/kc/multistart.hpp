@@ -0,0 +1,220 @@
+#ifndef KC_MULTISTART_HPP_
+#define KC_MULTISTART_HPP_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "kc/NativeCalibrator.hpp"
+#include "kc/evaluate.hpp"
+#include "kc/io.hpp"
+#include "kc/parallel.hpp"
+
+namespace kc
+{
+  struct MultiStartOptions
+  {
+    std::size_t   num_threads{default_threads()};
+    std::size_t   starts{64};           // the initial guess and starts - 1 perturbations of it
+    std::size_t   survivors{4};         // starts solved to convergence and returned
+    int           probe_iterations{3};  // LM iterations of every remaining start per culling round
+    std::size_t   probe_samples{4096};  // evenly spaced training samples the probes fit, 0 for all
+    double        length_sigma{0.01};   // [m] standard deviation of the perturbation of a and d
+    double        angle_sigma{0.05};    // [rad] of alpha and theta
+    std::size_t   flips{1};             // angles of every perturbed start offset by a multiple of pi/2
+    unsigned int  seed{1};
+    NativeOptions calibration{};        // of every solve, max_num_iterations bounding the final ones
+  };
+
+  struct MultiStartCandidate
+  {
+    std::size_t         start{};      // 0 for the initial guess
+    std::vector<double> parameters;   // a, alpha, d, theta of N links each
+    double              probe_cost{}; // training cost after the last culling round it ran in
+    int                 iterations{}; // over the probes and the final solve
+    NativeSummary       summary;      // of the final solve
+    Evaluation          validation;   // on the samples left out of the training
+  };
+
+  struct MultiStart
+  {
+    std::vector<MultiStartCandidate> candidates; // the survivors, by ascending validation RMSE
+    std::size_t                      starts{}, rounds{}, probes{};
+    double                           time_in_seconds{};
+  };
+
+  namespace detail
+  {
+    // Runs at most iterations LM iterations of kc::NativeCalibrator on parameters (a, alpha, d,
+    // theta of N links each) and returns its summary. If identify, the unidentifiable parameters
+    // are found at parameters (with options.fix_unidentifiable) and written to fixed, otherwise
+    // those fixed lists are held constant.
+    template<class Robot>
+    auto probe(const ColumnsView<Robot::N> &joint_angles, const ColumnsView<3> &xyz, const std::vector<SampleRange> &training,
+               double *const parameters, NativeOptions options, const int iterations,
+               std::array<std::vector<int>, 4> &fixed, const bool identify) -> NativeSummary
+    {
+      constexpr std::size_t N = Robot::N;
+
+      options.max_num_iterations           = iterations;
+      options.fix_unidentifiable           = identify && options.fix_unidentifiable;
+      options.minimizer_progress_to_stdout = false;
+      NativeCalibrator<Robot> calibrator(joint_angles, xyz, training, parameters, parameters + N, parameters + 2 * N, parameters + 3 * N, options);
+      if (identify)
+        fixed = calibrator.identifiability().fixed;
+      else
+        for (std::size_t block{}; block < 4; ++block)
+          for (const int link : fixed[block])
+            calibrator.set_constant(block, std::size_t(link));
+      return calibrator.solve();
+    }
+  } // namespace detail
+
+  // Multi-start calibration of Robot for initial guesses a, alpha, d, theta that may be far off,
+  // e.g. nominal values with an angle a quarter turn out. Besides the guess, options.starts - 1
+  // starts perturb every length and angle by Gaussian noise and options.flips of the angles by a
+  // random multiple of pi/2. The starts are solved by kc::NativeCalibrator in culling rounds:
+  // every remaining start runs options.probe_iterations LM iterations on options.probe_samples of
+  // the training samples, one start per thread, and the better half by cost goes on, until
+  // options.survivors remain. These are solved on all the training samples to
+  // convergence, the threads shared among them, evaluated on the samples after the training
+  // fraction and ranked by RMSE; the best is written back to a, alpha, d, theta. A wrong guess
+  // also misleads kc::identifiability, so the parameters to hold constant are found at every
+  // start and again at every survivor's estimate before its final solve. Every start is solved on
+  // one thread and the perturbations are drawn from options.seed up front, so the result does not
+  // depend on the number of threads.
+  template<class Robot>
+  auto multi_start(double *a, double *alpha, double *d, double *theta,
+                   const ColumnsView<Robot::N> &joint_angles, const ColumnsView<3> &xyz,
+                   const MultiStartOptions &options = {}, const EvaluationOptions &evaluation = {}) -> MultiStart
+  {
+    constexpr std::size_t N = Robot::N;
+
+    const auto start = std::chrono::steady_clock::now();
+    MultiStart out;
+    out.starts = std::max<std::size_t>(1, options.starts);
+
+    const std::size_t              samples  = xyz.rows();
+    const std::size_t              split    = std::min(samples, std::size_t(double(samples) * options.calibration.training_fraction));
+    const std::vector<SampleRange> training = {{0, split}};
+
+    // Starts, drawn in order from the seed
+    std::vector<MultiStartCandidate> candidates(out.starts);
+    std::mt19937                     generator{options.seed};
+    std::normal_distribution<double> noise{0., 1.};
+    std::uniform_int_distribution<>  quarter_turns{1, 3};
+    std::vector<std::size_t>         angles(2 * N);
+    for (std::size_t s{}; s < out.starts; ++s)
+    {
+      MultiStartCandidate &candidate = candidates[s];
+      candidate.start                = s;
+      candidate.parameters.resize(4 * N);
+      double *const parameters = candidate.parameters.data();
+      std::copy_n(a, N, parameters);
+      std::copy_n(alpha, N, parameters + N);
+      std::copy_n(d, N, parameters + 2 * N);
+      std::copy_n(theta, N, parameters + 3 * N);
+      if (s == 0) continue;
+
+      for (std::size_t block{}; block < 4; ++block)
+        for (std::size_t link{}; link < N; ++link)
+          parameters[block * N + link] += (block % 2 == 0 ? options.length_sigma : options.angle_sigma) * noise(generator);
+
+      // Angles to flip, as indices into parameters: alpha and theta of every link, in random order
+      for (std::size_t link{}; link < N; ++link)
+      {
+        angles[2 * link]     = N + link;
+        angles[2 * link + 1] = 3 * N + link;
+      }
+      std::shuffle(angles.begin(), angles.end(), generator);
+      for (std::size_t flip{}; flip < std::min(options.flips, angles.size()); ++flip)
+        parameters[angles[flip]] += quarter_turns(generator) * M_PI / 2.;
+
+      if (!options.calibration.bounded) continue;
+      for (std::size_t link{}; link < N; ++link)
+        for (std::size_t block{}; block < 4; ++block)
+        {
+          double &value = parameters[block * N + link];
+          value         = block % 2 == 0 ? std::max(0., value) : value - 2. * M_PI * std::floor(value / (2. * M_PI));
+        }
+    }
+
+    NativeOptions probe_options = options.calibration;
+    probe_options.num_threads   = 1;
+
+    // The probes only rank the starts, so they fit an evenly spaced subset of the training samples
+    std::vector<std::size_t> rows;
+    for (std::size_t i{}; options.probe_samples > 0 && options.probe_samples < split && i < options.probe_samples; ++i)
+      rows.push_back(i * split / options.probe_samples);
+    const Columns<N>               probe_joint_angles = gather(joint_angles, rows);
+    const Columns<3>               probe_xyz          = gather(xyz, rows);
+    const ColumnsView<N>           probe_q            = rows.empty() ? joint_angles : probe_joint_angles.view();
+    const ColumnsView<3>           probe_p            = rows.empty() ? xyz : probe_xyz.view();
+    const std::vector<SampleRange> probe_training     = {{0, rows.empty() ? split : rows.size()}};
+
+    // Culling rounds over the remaining starts, ordered by index so that ties keep the earlier start
+    const std::size_t                            survivors = std::clamp<std::size_t>(options.survivors, 1, out.starts);
+    std::vector<std::array<std::vector<int>, 4>> fixed(out.starts);
+    std::vector<std::size_t>                     remaining(out.starts);
+    std::iota(remaining.begin(), remaining.end(), std::size_t{0});
+    const auto cost = [&](const std::size_t s) {
+      return std::isfinite(candidates[s].probe_cost) ? candidates[s].probe_cost : std::numeric_limits<double>::infinity();
+    };
+    while (remaining.size() > survivors)
+    {
+      out.probes += std::size_t(std::count_if(remaining.begin(), remaining.end(),
+                                              [&](const std::size_t s) { return !candidates[s].summary.converged; }));
+      parallel_for(remaining.size(), options.num_threads, [&](const std::size_t i) {
+        MultiStartCandidate &candidate = candidates[remaining[i]];
+        if (candidate.summary.converged) return;
+        candidate.summary    = detail::probe<Robot>(probe_q, probe_p, probe_training, candidate.parameters.data(), probe_options,
+                                                    options.probe_iterations, fixed[candidate.start], out.rounds == 0);
+        candidate.probe_cost = candidate.summary.final_cost;
+        candidate.iterations += candidate.summary.iterations;
+      });
+      ++out.rounds;
+
+      std::stable_sort(remaining.begin(), remaining.end(), [&](const std::size_t i, const std::size_t j) { return cost(i) < cost(j); });
+      remaining.resize(std::max(survivors, (remaining.size() + 1) / 2));
+      std::sort(remaining.begin(), remaining.end());
+    }
+
+    // Survivors to convergence, sharing the threads as kc::cross_validate shares them among folds
+    const std::size_t outer = std::min(remaining.size(), std::max<std::size_t>(1, options.num_threads));
+    NativeOptions     solve = options.calibration;
+    solve.num_threads       = std::max<std::size_t>(1, options.num_threads / outer);
+    EvaluationOptions held_out = evaluation;
+    held_out.num_threads       = solve.num_threads;
+    parallel_for(remaining.size(), outer, [&](const std::size_t i) {
+      MultiStartCandidate &candidate  = candidates[remaining[i]];
+      double *const        parameters = candidate.parameters.data();
+      candidate.summary = detail::probe<Robot>(joint_angles, xyz, training, parameters, solve, solve.max_num_iterations,
+                                               fixed[candidate.start], true);
+      candidate.iterations += candidate.summary.iterations;
+      candidate.validation = evaluate<Robot>(parameters, parameters + N, parameters + 2 * N, parameters + 3 * N,
+                                             joint_angles, xyz, split, samples, held_out);
+    });
+
+    for (const std::size_t s : remaining)
+      out.candidates.push_back(std::move(candidates[s]));
+    std::stable_sort(out.candidates.begin(), out.candidates.end(), [](const MultiStartCandidate &x, const MultiStartCandidate &y) {
+      return std::pair{x.validation.rmse, x.summary.final_cost} < std::pair{y.validation.rmse, y.summary.final_cost};
+    });
+
+    const double *const best = out.candidates.front().parameters.data();
+    std::copy_n(best, N, a);
+    std::copy_n(best + N, N, alpha);
+    std::copy_n(best + 2 * N, N, d);
+    std::copy_n(best + 3 * N, N, theta);
+    out.time_in_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return out;
+  }
+} // namespace kc
+
+#endif // KC_MULTISTART_HPP_
@@ -0,0 +1,41 @@
+#ifndef KC_PARALLEL_HPP_
+#define KC_PARALLEL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace kc
+{
+  [[nodiscard]] inline auto default_threads() -> std::size_t
+  {
+    return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  }
+
+  // Calls task(chunk) for every chunk in [0, chunks) on up to num_threads threads, the calling
+  // thread included. Chunks are handed out dynamically, so results that must not depend on the
+  // number of threads should be written per chunk and combined in chunk order afterwards.
+  template<class Task>
+  void parallel_for(const std::size_t chunks, const std::size_t num_threads, const Task &task)
+  {
+    const std::size_t        threads = std::clamp<std::size_t>(num_threads, 1, std::max<std::size_t>(1, chunks));
+    std::atomic<std::size_t> next{0};
+
+    const auto worker = [&] {
+      for (std::size_t chunk = next.fetch_add(1, std::memory_order_relaxed); chunk < chunks;
+           chunk             = next.fetch_add(1, std::memory_order_relaxed))
+        task(chunk);
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (std::size_t thread{1}; thread < threads; ++thread)
+      workers.emplace_back(worker);
+    worker();
+    for (auto &thread : workers)
+      thread.join();
+  }
+} // namespace kc
+
+#endif // KC_PARALLEL_HPP_
@@ -0,0 +1,39 @@
+#ifndef KC_ROBOTS_HPP_
+#define KC_ROBOTS_HPP_
+
+#include <string>
+
+#include "kc/Link.hpp"
+#include "kc/Robot.hpp"
+
+namespace kc::robots
+{
+  using ThreeR   = Robot<LR, LR, LR>;
+  using Stanford = Robot<LR, LR, LP, LR, LR, LR>;
+  using KUKA     = Robot<LR, LR, LR, LR, LR, LR, LR>;
+
+  template<class R>
+  struct Tag
+  {
+    using type = R;
+  };
+
+  // Calls visitor(Tag<Robot>{}) with the robot known by name, either its model ("3R",
+  // "Stanford", "KUKA") or its joint sequence ("RRR", "RRPRRR", "RRRRRRR"). Returns false when no
+  // instantiation matches, in which case visitor is not called.
+  template<class Visitor>
+  auto visit(const std::string &name, Visitor &&visitor) -> bool
+  {
+    if (name == "3R" || name == ThreeR::shape())
+      visitor(Tag<ThreeR>{});
+    else if (name == "Stanford" || name == Stanford::shape())
+      visitor(Tag<Stanford>{});
+    else if (name == "KUKA" || name == KUKA::shape())
+      visitor(Tag<KUKA>{});
+    else
+      return false;
+    return true;
+  }
+} // namespace kc::robots
+
+#endif // KC_ROBOTS_HPP_
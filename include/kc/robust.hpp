@@ -0,0 +1,267 @@
+#ifndef KC_ROBUST_HPP_
+#define KC_ROBUST_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "kc/Calibrator.hpp"
+#include "kc/Robot.hpp"
+#include "kc/evaluate.hpp"
+#include "kc/io.hpp"
+#include "kc/parallel.hpp"
+
+#include "ceres/ceres.h"
+
+namespace kc
+{
+  // Loss applied to the position error e of each sample: Huber (quadratic up to the scale c,
+  // linear beyond) or Cauchy (c^2 log(1 + e^2 / c^2)). Trivial keeps plain least squares.
+  enum class Loss
+  {
+    Trivial,
+    Huber,
+    Cauchy
+  };
+
+  // How the outlier threshold is taken from the errors at the initial guess
+  enum class Threshold
+  {
+    MAD,     // median + mad_factor * 1.4826 * MAD
+    Quantile // quantile of the errors
+  };
+
+  struct RobustOptions
+  {
+    std::size_t num_threads{default_threads()};
+    Threshold   threshold{Threshold::MAD};
+    double      mad_factor{5.};
+    double      quantile{0.99};
+    Loss        loss{Loss::Huber};
+    double      loss_scale{}; // c [m]; 0: median + k * 1.4826 * MAD of the inlier errors, k the 95% efficiency constant of the loss
+    std::size_t reweighting_iterations{2};
+    int         reweighting_max_iterations{5}; // of each round, warm-started from the previous fit
+  };
+
+  struct Screening
+  {
+    std::vector<SampleRange> inliers; // runs of consecutive samples at or below the threshold
+    std::size_t              samples{}, rejected{};
+    double                   median{}, mad{}, threshold{};
+  };
+
+  struct RobustCalibration
+  {
+    std::size_t                         training{}; // samples [0, training) were screened and fitted
+    Screening                           screening;
+    double                              loss_scale{};
+    std::vector<ceres::Solver::Summary> summaries; // the plain solve, then one per reweighting
+  };
+
+  namespace detail
+  {
+    // Median and median absolute deviation of a non-empty set of values, which are reordered
+    [[nodiscard]] inline auto median_mad(std::vector<double> &values) -> std::pair<double, double>
+    {
+      const double median = percentile(values, 0.5);
+      for (double &value : values)
+        value = std::abs(value - median);
+      return {median, percentile(values, 0.5)};
+    }
+
+    [[nodiscard]] inline auto efficiency_constant(const Loss loss) -> double
+    {
+      return loss == Loss::Cauchy ? 2.3849 : 1.345;
+    }
+  } // namespace detail
+
+  // Position errors |fk(q) - p| of samples [begin, end), computed lane-wise in parallel as in
+  // kc::evaluate; out[i - begin] is the error of sample i.
+  template<class Robot>
+  [[nodiscard]] auto position_errors(const double *const a, const double *const alpha,
+                                     const double *const d, const double *const theta,
+                                     const ColumnsView<Robot::N> &joint_angles, const ColumnsView<3> &xyz,
+                                     const std::size_t begin, const std::size_t end,
+                                     const std::size_t num_threads = default_threads()) -> std::vector<double>
+  {
+    constexpr std::size_t Chunk = detail::evaluation_chunk;
+
+    std::vector<double> out(end - begin);
+    parallel_for((out.size() + Chunk - 1) / Chunk, num_threads, [&](const std::size_t chunk) {
+      const std::size_t first = begin + chunk * Chunk;
+      const std::size_t count = std::min(Chunk, end - first);
+
+      double predicted[3][Chunk];
+      Robot::fk_batch(a, alpha, d, theta, joint_angles.data() + first, joint_angles.rows(), count, &predicted[0][0], Chunk);
+      for (std::size_t i{}; i < count; ++i)
+      {
+        const double x         = predicted[0][i] - xyz.column(0)[first + i];
+        const double y         = predicted[1][i] - xyz.column(1)[first + i];
+        const double z         = predicted[2][i] - xyz.column(2)[first + i];
+        out[first - begin + i] = std::sqrt(x * x + y * y + z * z);
+      }
+    });
+    return out;
+  }
+
+  // Screens samples [begin, end) at the DH parameters a, alpha, d, theta (usually the initial
+  // guess): samples whose error exceeds the threshold of options are rejected before the solve.
+  // Nothing is rejected by the MAD rule when half of the errors or more coincide (MAD = 0).
+  template<class Robot>
+  [[nodiscard]] auto screen(const double *const a, const double *const alpha,
+                            const double *const d, const double *const theta,
+                            const ColumnsView<Robot::N> &joint_angles, const ColumnsView<3> &xyz,
+                            const std::size_t begin, const std::size_t end,
+                            const RobustOptions &options = {}) -> Screening
+  {
+    Screening out;
+    out.samples = end - begin;
+    if (out.samples == 0) return out;
+
+    const std::vector<double> errors = position_errors<Robot>(a, alpha, d, theta, joint_angles, xyz, begin, end, options.num_threads);
+
+    std::vector<double> scratch = errors;
+    std::tie(out.median, out.mad) = detail::median_mad(scratch);
+    if (options.threshold == Threshold::Quantile)
+    {
+      scratch       = errors;
+      out.threshold = detail::percentile(scratch, options.quantile);
+    }
+    else
+      out.threshold = out.mad > 0. ? out.median + options.mad_factor * 1.4826 * out.mad : std::numeric_limits<double>::infinity();
+
+    for (std::size_t i{}; i < errors.size();)
+    {
+      if (errors[i] > out.threshold)
+      {
+        ++out.rejected;
+        ++i;
+        continue;
+      }
+      const std::size_t first = i;
+      while (i < errors.size() && errors[i] <= out.threshold)
+        ++i;
+      out.inliers.emplace_back(begin + first, begin + i);
+    }
+    return out;
+  }
+
+  // Weight of a sample with error e in iteratively reweighted least squares, rho'(e^2) of the loss
+  // with scale c: 1 inside c, c / e (Huber) or 1 / (1 + e^2 / c^2) (Cauchy) beyond.
+  [[nodiscard]] inline auto loss_weight(const Loss loss, const double scale, const double error) -> double
+  {
+    switch (loss)
+    {
+    case Loss::Huber:
+      return error <= scale ? 1. : scale / error;
+    case Loss::Cauchy:
+      return 1. / (1. + (error * error) / (scale * scale));
+    default:
+      return 1.;
+    }
+  }
+
+  // Fills weights (one per sample of the dataset, zero outside ranges) with the loss weights of
+  // the samples in ranges, sorted as kc::screen returns them, at the current DH parameters and
+  // returns the loss scale used.
+  template<class Robot>
+  auto robust_weights(const double *const a, const double *const alpha,
+                      const double *const d, const double *const theta,
+                      const ColumnsView<Robot::N> &joint_angles, const ColumnsView<3> &xyz,
+                      const std::vector<SampleRange> &ranges, const RobustOptions &options,
+                      std::vector<double> &weights) -> double
+  {
+    weights.assign(xyz.rows(), 0.);
+    if (ranges.empty()) return options.loss_scale;
+
+    // One pass over the span of the ranges, which the screening leaves close to contiguous
+    const std::size_t         first = ranges.front().first, last = ranges.back().second;
+    const std::vector<double> span  = position_errors<Robot>(a, alpha, d, theta, joint_angles, xyz, first, last, options.num_threads);
+
+    std::vector<double> errors;
+    for (const auto &[begin, end] : ranges)
+      errors.insert(errors.end(), span.begin() + std::ptrdiff_t(begin - first), span.begin() + std::ptrdiff_t(end - first));
+    if (errors.empty()) return options.loss_scale;
+
+    double scale = options.loss_scale;
+    if (scale <= 0.)
+    {
+      const auto [median, mad] = detail::median_mad(errors);
+      scale                    = median + detail::efficiency_constant(options.loss) * 1.4826 * mad;
+    }
+    scale = std::max(scale, std::numeric_limits<double>::min());
+
+    for (const auto &[begin, end] : ranges)
+      for (std::size_t i{begin}; i < end; ++i)
+        weights[i] = loss_weight(options.loss, scale, span[i - first]);
+    return scale;
+  }
+
+  // Calibrates Robot on the training split of calibration with outliers screened out at the
+  // initial guess, then, unless the loss is Trivial, refines the fit by iteratively reweighted
+  // least squares: every round weights the inliers by the loss at the current parameters and
+  // solves again from there. The rounds start next to their optimum, so they run at most
+  // options.reweighting_max_iterations iterations, and hold constant the parameters the first
+  // solve found unidentifiable rather than analysing them again. They stop early once a round
+  // leaves the parameters, and therefore the weights, unchanged.
+  template<class Robot, std::size_t B = 64>
+  auto robust_calibrate(const ColumnsView<Robot::N> &joint_angles, const ColumnsView<3> &xyz,
+                        double *a, double *alpha, double *d, double *theta,
+                        const CalibrationOptions &calibration = {}, const RobustOptions &options = {}) -> RobustCalibration
+  {
+    RobustCalibration out;
+    out.training  = std::min(xyz.rows(), std::size_t(double(xyz.rows()) * calibration.training_fraction));
+    out.screening = screen<Robot>(a, alpha, d, theta, joint_angles, xyz, 0, out.training, options);
+
+    Identifiability identifiability;
+    {
+      Calibrator<Robot, B> calibrator(joint_angles, xyz, out.screening.inliers, a, alpha, d, theta, calibration);
+      out.summaries.push_back(calibrator.solve());
+      identifiability = calibrator.identifiability();
+    }
+    if (options.loss == Loss::Trivial) return out;
+
+    CalibrationOptions refinement = calibration;
+    refinement.max_num_iterations = options.reweighting_max_iterations;
+    refinement.fix_unidentifiable = false;
+
+    constexpr std::size_t N = Robot::N;
+
+    std::vector<double> weights;
+    for (std::size_t round{}; round < options.reweighting_iterations; ++round)
+    {
+      std::array<double, 4 * N> previous;
+      std::copy_n(a, N, previous.begin());
+      std::copy_n(alpha, N, previous.begin() + N);
+      std::copy_n(d, N, previous.begin() + 2 * N);
+      std::copy_n(theta, N, previous.begin() + 3 * N);
+
+      out.loss_scale = robust_weights<Robot>(a, alpha, d, theta, joint_angles, xyz, out.screening.inliers, options, weights);
+      Calibrator<Robot, B> calibrator(joint_angles, xyz, out.screening.inliers, a, alpha, d, theta, refinement, weights.data());
+      if (calibration.fix_unidentifiable) hold_unidentifiable(calibrator.problem(), identifiability, a, alpha, d, theta);
+      out.summaries.push_back(calibrator.solve());
+
+      if (std::equal(a, a + N, previous.begin()) && std::equal(alpha, alpha + N, previous.begin() + N) &&
+          std::equal(d, d + N, previous.begin() + 2 * N) && std::equal(theta, theta + N, previous.begin() + 3 * N))
+        break;
+    }
+    return out;
+  }
+
+  inline void report(const Screening &screening)
+  {
+    std::cout << std::fixed << std::setprecision(6)
+              << "Screened samples:    " << screening.samples << "\n"
+              << "Rejected samples:    " << screening.rejected << "\n"
+              << "Median/MAD [m]:      " << screening.median << " " << screening.mad << "\n"
+              << "Threshold [m]:       " << screening.threshold << "\n";
+  }
+} // namespace kc
+
+#endif // KC_ROBUST_HPP_
@@ -0,0 +1,127 @@
+#ifndef KC_SELECT_HPP_
+#define KC_SELECT_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "kc/Robot.hpp"
+#include "kc/io.hpp"
+#include "kc/parallel.hpp"
+
+#include "Eigen/Dense"
+
+namespace kc
+{
+  struct SelectionOptions
+  {
+    std::size_t  num_threads{default_threads()};
+    double       ridge{1e-6};    // prior information, relative to the mean eigenvalue of the full information matrix
+    double       tolerance{0.01}; // delta of stochastic greedy: each step scores (candidates / K) ln(1 / delta) samples
+    unsigned int seed{1};
+  };
+
+  struct Selection
+  {
+    std::vector<std::size_t> samples;   // selected sample indices, ascending
+    double                   log_det{}; // log det of the (ridged) information matrix of the selection
+    double                   full_log_det{};
+    double                   efficiency{};  // per-sample D-efficiency of the selection against all candidates
+    std::size_t              evaluations{}; // gains scored by the greedy search
+  };
+
+  // Greedy D-optimal selection of K of the samples [begin, end) for calibrating Robot around the
+  // DH parameters a, alpha, d, theta. Every sample contributes J^T J to the information matrix M of
+  // the 4N parameters, J being its 3 x 4N Robot::jacobian; samples are added one at a time, each
+  // maximising the increase of log det M, log det(I + J M^-1 J^T). Scoring every candidate at every
+  // step costs O(candidates K N^2), so each step scores a random draw of the remaining candidates
+  // instead (stochastic greedy), which keeps the greedy guarantee up to tolerance at
+  // O(candidates ln(1 / tolerance) N^2) overall. M^-1 follows by rank-3 Woodbury updates. Nearly
+  // repeated poses add almost nothing once one of them is in and are left out.
+  template<class Robot>
+  [[nodiscard]] auto select_samples(const double *const a, const double *const alpha,
+                                    const double *const d, const double *const theta,
+                                    const ColumnsView<Robot::N> &joint_angles,
+                                    const std::size_t begin, const std::size_t end, const std::size_t K,
+                                    const SelectionOptions &options = {}) -> Selection
+  {
+    constexpr std::size_t P     = 4 * Robot::N;
+    constexpr std::size_t Chunk = 1024;
+
+    using Information = Eigen::Matrix<double, P, P>;
+    using Jacobian    = typename Robot::JacobianMatrix;
+
+    Selection         out;
+    const std::size_t candidates = end - begin;
+    if (candidates == 0 || K == 0) return out;
+
+    // Jacobians of every candidate and the full information matrix, reduced in chunk order
+    const std::size_t        chunks = (candidates + Chunk - 1) / Chunk;
+    std::vector<Jacobian>    jacobians(candidates);
+    std::vector<Information> partials(chunks, Information::Zero());
+    parallel_for(chunks, options.num_threads, [&](const std::size_t chunk) {
+      const std::size_t last = std::min(candidates, (chunk + 1) * Chunk);
+      for (std::size_t i{chunk * Chunk}; i < last; ++i)
+      {
+        jacobians[i] = Robot::jacobian(a, alpha, d, theta, joint_angles.row(begin + i));
+        partials[chunk].template selfadjointView<Eigen::Lower>().rankUpdate(jacobians[i].transpose());
+      }
+    });
+    Information full = Information::Zero();
+    for (const Information &partial : partials)
+      full += partial;
+    full = full.template selfadjointView<Eigen::Lower>();
+
+    const double epsilon = std::max(options.ridge * full.trace() / double(P), std::numeric_limits<double>::min());
+    out.full_log_det     = 2. * (full + epsilon * Information::Identity()).llt().matrixLLT().diagonal().array().log().sum();
+
+    Information inverse = Information::Identity() / epsilon;
+    out.log_det         = double(P) * std::log(epsilon);
+
+    const std::size_t count = std::min(K, candidates);
+    const std::size_t draws = std::max<std::size_t>(1, std::size_t(std::ceil(double(candidates) / double(count) * std::log(1. / options.tolerance))));
+
+    std::vector<std::size_t> remaining(candidates);
+    std::iota(remaining.begin(), remaining.end(), 0);
+    std::mt19937 generator{options.seed};
+    while (out.samples.size() < count)
+    {
+      // Partial Fisher-Yates shuffle: remaining[0, draw) is a uniform draw of the candidates left
+      const std::size_t draw = std::min(draws, remaining.size());
+      std::size_t       best{};
+      double            best_gain{-std::numeric_limits<double>::infinity()};
+      for (std::size_t i{}; i < draw; ++i)
+      {
+        std::swap(remaining[i], remaining[i + std::uniform_int_distribution<std::size_t>{0, remaining.size() - i - 1}(generator)]);
+        const Jacobian       &J    = jacobians[remaining[i]];
+        const Eigen::Matrix3d S    = Eigen::Matrix3d::Identity() + J * inverse.template selfadjointView<Eigen::Lower>() * J.transpose();
+        const double          gain = std::log(S.determinant());
+        if (gain > best_gain)
+        {
+          best_gain = gain;
+          best      = i;
+        }
+      }
+      out.evaluations += draw;
+
+      const Jacobian                   &J = jacobians[remaining[best]];
+      const Eigen::Matrix<double, P, 3> U = inverse.template selfadjointView<Eigen::Lower>() * J.transpose();
+      const Eigen::Matrix3d             S = Eigen::Matrix3d::Identity() + J * U;
+      inverse.template selfadjointView<Eigen::Lower>().rankUpdate(U * S.llt().matrixL().solve(Eigen::Matrix3d::Identity()).transpose(), -1.);
+      out.log_det += best_gain;
+      out.samples.push_back(begin + remaining[best]);
+
+      remaining[best] = remaining.back();
+      remaining.pop_back();
+    }
+
+    std::sort(out.samples.begin(), out.samples.end());
+    out.efficiency = std::exp((out.log_det - out.full_log_det) / double(P)) * double(candidates) / double(out.samples.size());
+    return out;
+  }
+} // namespace kc
+
+#endif // KC_SELECT_HPP_
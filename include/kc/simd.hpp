@@ -0,0 +1,108 @@
+#ifndef KC_SIMD_HPP_
+#define KC_SIMD_HPP_
+
+#include <cstdint>
+#include <cstring>
+
+namespace kc
+{
+  namespace simd
+  {
+    // Number of doubles processed together by the lane-wise kernels: wide enough to fill an
+    // AVX-512 or AVX2 register, the loops below being written so that the compiler maps one
+    // iteration over the lanes to a single vector instruction.
+#if defined(__AVX512F__)
+    inline constexpr std::size_t width = 8;
+#elif defined(__AVX__)
+    inline constexpr std::size_t width = 4;
+#else
+    inline constexpr std::size_t width = 2;
+#endif
+
+    // Lanes of scalar T filling the same registers, twice as many for float
+    template<class T>
+    inline constexpr std::size_t lanes = width * sizeof(double) / sizeof(T);
+
+    // Branch-free sine and cosine of W angles. The argument is reduced to [-pi/4, pi/4] with a
+    // three-part Cody-Waite split of pi/2 and evaluated with the fdlibm kernel polynomials, which
+    // keeps the result within an ulp of std::sin/std::cos for |x| < 2^20.
+    template<std::size_t W>
+    inline void sincos(const double *const x, double *const sin_x, double *const cos_x)
+    {
+      constexpr double two_over_pi = 6.36619772367581382433e-01;
+      constexpr double pio2_1      = 1.57079632673412561417e+00;
+      constexpr double pio2_2      = 6.07710050630396597660e-11;
+      constexpr double pio2_3      = 2.02226624879595063154e-21;
+      constexpr double round_magic = 6755399441055744.0; // 1.5 * 2^52
+
+      constexpr double S1 = -1.66666666666666324348e-01, S2 = 8.33333333332248946124e-03,
+                       S3 = -1.98412698298579493134e-04, S4 = 2.75573137070700676789e-06,
+                       S5 = -2.50507602534068634195e-08, S6 = 1.58969099521155010221e-10;
+      constexpr double C1 = 4.16666666666666019037e-02, C2 = -1.38888888888741095749e-03,
+                       C3 = 2.48015872894767294178e-05, C4 = -2.75573143513906633035e-07,
+                       C5 = 2.08757232129817482790e-09, C6 = -1.13596475577881948265e-11;
+
+      for (std::size_t lane{}; lane < W; ++lane)
+      {
+        // Nearest multiple of pi/2; the low bits of the shifted mantissa give the quadrant
+        const double  shifted = x[lane] * two_over_pi + round_magic;
+        std::uint64_t bits;
+        std::memcpy(&bits, &shifted, sizeof(bits));
+        const double k = shifted - round_magic;
+        const double r = ((x[lane] - k * pio2_1) - k * pio2_2) - k * pio2_3;
+
+        const double z  = r * r;
+        const double s  = r + r * z * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)))));
+        const double hz = 0.5 * z;
+        const double w  = 1.0 - hz;
+        const double c  = w + (((1.0 - w) - hz) + z * z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6))))));
+
+        const bool   swap    = (bits & 1U) != 0U;
+        const bool   neg_sin = (bits & 2U) != 0U;
+        const bool   neg_cos = ((bits + 1U) & 2U) != 0U;
+        const double sin_r   = swap ? c : s;
+        const double cos_r   = swap ? s : c;
+        sin_x[lane]          = neg_sin ? -sin_r : sin_r;
+        cos_x[lane]          = neg_cos ? -cos_r : cos_r;
+      }
+    }
+
+    // Single-precision counterpart of the above: a three-part split of pi/2 in float and the
+    // Cephes sinf/cosf polynomials, within a few float ulps of std::sin/std::cos for |x| < 2^13.
+    template<std::size_t W>
+    inline void sincos(const float *const x, float *const sin_x, float *const cos_x)
+    {
+      constexpr float two_over_pi = 6.36619772e-01F;
+      constexpr float pio2_1      = 1.5703125F;
+      constexpr float pio2_2      = 4.837512969970703125e-4F;
+      constexpr float pio2_3      = 7.54978995489188216e-8F;
+      constexpr float round_magic = 12582912.F; // 1.5 * 2^23
+
+      constexpr float S1 = -1.6666654611e-1F, S2 = 8.3321608736e-3F, S3 = -1.9515295891e-4F;
+      constexpr float C1 = 4.166664568298827e-2F, C2 = -1.388731625493765e-3F, C3 = 2.443315711809948e-5F;
+
+      for (std::size_t lane{}; lane < W; ++lane)
+      {
+        const float   shifted = x[lane] * two_over_pi + round_magic;
+        std::uint32_t bits;
+        std::memcpy(&bits, &shifted, sizeof(bits));
+        const float k = shifted - round_magic;
+        const float r = ((x[lane] - k * pio2_1) - k * pio2_2) - k * pio2_3;
+
+        const float z = r * r;
+        const float s = r + r * z * (S1 + z * (S2 + z * S3));
+        const float c = 1.F - 0.5F * z + z * z * (C1 + z * (C2 + z * C3));
+
+        const bool  swap    = (bits & 1U) != 0U;
+        const bool  neg_sin = (bits & 2U) != 0U;
+        const bool  neg_cos = ((bits + 1U) & 2U) != 0U;
+        const float sin_r   = swap ? c : s;
+        const float cos_r   = swap ? s : c;
+        sin_x[lane]         = neg_sin ? -sin_r : sin_r;
+        cos_x[lane]         = neg_cos ? -cos_r : cos_r;
+      }
+    }
+  } // namespace simd
+} // namespace kc
+
+#endif // KC_SIMD_HPP_
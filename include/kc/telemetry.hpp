@@ -0,0 +1,237 @@
+#ifndef KC_TELEMETRY_HPP_
+#define KC_TELEMETRY_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+// Instrumentation of the kinematics kernels and cost functions, compiled in only when
+// KC_INSTRUMENTATION is defined (the KC_INSTRUMENTATION CMake option). Otherwise KC_TELEMETRY_COUNT
+// and KC_TELEMETRY_TIME expand to nothing and kc::telemetry::snapshot() is empty.
+#if defined(KC_INSTRUMENTATION)
+#define KC_TELEMETRY_COUNT(counter, n) ::kc::telemetry::count(::kc::telemetry::Counter::counter, n)
+#define KC_TELEMETRY_TIME(probe)       const ::kc::telemetry::ScopedTimer kc_telemetry_timer_{::kc::telemetry::Probe::probe}
+#else
+#define KC_TELEMETRY_COUNT(counter, n) ((void)0)
+#define KC_TELEMETRY_TIME(probe)       ((void)0)
+#endif
+
+namespace kc::telemetry
+{
+  enum class Counter
+  {
+    FK,             // Robot::fk calls
+    FKBatch,        // Robot::fk_batch calls
+    FKBatchSamples, // samples through Robot::fk_batch
+    Allocations,    // operator new calls, if KC_TELEMETRY_ALLOCATION_HOOKS() is expanded
+    Count
+  };
+
+  enum class Probe
+  {
+    Evaluate, // CostFunction::Evaluate and its batched and dynamic variants
+    Jacobian, // Robot::fk_jacobian
+    Count
+  };
+
+  constexpr std::size_t counter_count = std::size_t(Counter::Count);
+  constexpr std::size_t probe_count   = std::size_t(Probe::Count);
+  constexpr std::size_t buckets       = 40; // bucket b: latencies in [2^b, 2^(b+1)) ns
+
+  struct ProbeSnapshot
+  {
+    std::uint64_t                      calls{}, nanoseconds{};
+    std::array<std::uint64_t, buckets> histogram{};
+  };
+
+  struct Snapshot
+  {
+    std::array<std::uint64_t, counter_count> counts{};
+    std::array<ProbeSnapshot, probe_count>   probes{};
+
+    [[nodiscard]] auto operator[](const Counter counter) const -> std::uint64_t { return this->counts[std::size_t(counter)]; }
+    [[nodiscard]] auto operator[](const Probe probe) const -> const ProbeSnapshot & { return this->probes[std::size_t(probe)]; }
+
+    // Counts accumulated since earlier
+    [[nodiscard]] auto operator-(const Snapshot &earlier) const -> Snapshot
+    {
+      Snapshot out;
+      for (std::size_t i{}; i < counter_count; ++i)
+        out.counts[i] = this->counts[i] - earlier.counts[i];
+      for (std::size_t i{}; i < probe_count; ++i)
+      {
+        out.probes[i].calls       = this->probes[i].calls - earlier.probes[i].calls;
+        out.probes[i].nanoseconds = this->probes[i].nanoseconds - earlier.probes[i].nanoseconds;
+        for (std::size_t b{}; b < buckets; ++b)
+          out.probes[i].histogram[b] = this->probes[i].histogram[b] - earlier.probes[i].histogram[b];
+      }
+      return out;
+    }
+  };
+
+  namespace detail
+  {
+    // Counters of one thread. Only the owning thread writes them, with plain relaxed loads and
+    // stores, so the hot path has no locked instruction; snapshot() reads them with relaxed
+    // loads. Blocks are linked into a registry when the thread first counts and fold their counts
+    // into it when the thread exits.
+    struct alignas(64) Block
+    {
+      std::array<std::atomic<std::uint64_t>, counter_count>                    counts{};
+      std::array<std::atomic<std::uint64_t>, probe_count>                      calls{}, nanoseconds{};
+      std::array<std::array<std::atomic<std::uint64_t>, buckets>, probe_count> histograms{};
+      Block                                                                   *previous{}, *next{};
+
+      Block();
+      ~Block();
+    };
+
+    // Intrusive list of the live blocks, so that registering a thread never allocates (which the
+    // allocation hooks would count, recursively)
+    struct Registry
+    {
+      std::mutex mutex;
+      Block     *head{};
+      Snapshot   retired; // counts of the threads that exited
+    };
+
+    inline auto registry() -> Registry &
+    {
+      static Registry registry;
+      return registry;
+    }
+
+    inline auto local() -> Block &
+    {
+      thread_local Block block;
+      return block;
+    }
+
+    inline void add(std::atomic<std::uint64_t> &counter, const std::uint64_t n)
+    {
+      counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    inline void accumulate(const Block &block, Snapshot &out)
+    {
+      for (std::size_t i{}; i < counter_count; ++i)
+        out.counts[i] += block.counts[i].load(std::memory_order_relaxed);
+      for (std::size_t i{}; i < probe_count; ++i)
+      {
+        out.probes[i].calls += block.calls[i].load(std::memory_order_relaxed);
+        out.probes[i].nanoseconds += block.nanoseconds[i].load(std::memory_order_relaxed);
+        for (std::size_t b{}; b < buckets; ++b)
+          out.probes[i].histogram[b] += block.histograms[i][b].load(std::memory_order_relaxed);
+      }
+    }
+
+    inline Block::Block()
+    {
+      Registry                        &shared = registry();
+      const std::lock_guard<std::mutex> lock{shared.mutex};
+      this->next = shared.head;
+      if (shared.head != nullptr) shared.head->previous = this;
+      shared.head = this;
+    }
+
+    inline Block::~Block()
+    {
+      Registry                        &shared = registry();
+      const std::lock_guard<std::mutex> lock{shared.mutex};
+      accumulate(*this, shared.retired);
+      if (this->previous != nullptr) this->previous->next = this->next;
+      if (this->next != nullptr) this->next->previous = this->previous;
+      if (shared.head == this) shared.head = this->next;
+    }
+
+    [[nodiscard]] inline auto bucket(std::uint64_t nanoseconds) -> std::size_t
+    {
+      std::size_t out{};
+      while (nanoseconds > 1 && out + 1 < buckets)
+      {
+        nanoseconds >>= 1;
+        ++out;
+      }
+      return out;
+    }
+  } // namespace detail
+
+  inline void count(const Counter counter, const std::uint64_t n = 1)
+  {
+    detail::add(detail::local().counts[std::size_t(counter)], n);
+  }
+
+  inline void record(const Probe probe, const std::uint64_t nanoseconds)
+  {
+    detail::Block    &block = detail::local();
+    const std::size_t i     = std::size_t(probe);
+    detail::add(block.calls[i], 1);
+    detail::add(block.nanoseconds[i], nanoseconds);
+    detail::add(block.histograms[i][detail::bucket(nanoseconds)], 1);
+  }
+
+  // Times its scope into a probe
+  struct ScopedTimer
+  {
+    explicit ScopedTimer(const Probe probe) : probe_{probe}, start_{std::chrono::steady_clock::now()} {}
+    ~ScopedTimer()
+    {
+      record(this->probe_, std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start_).count()));
+    }
+    ScopedTimer(const ScopedTimer &)                     = delete;
+    auto operator=(const ScopedTimer &) -> ScopedTimer & = delete;
+
+  private:
+    Probe                                 probe_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  [[nodiscard]] inline constexpr auto enabled() -> bool
+  {
+#if defined(KC_INSTRUMENTATION)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  // Totals over every thread since the start of the program
+  [[nodiscard]] inline auto snapshot() -> Snapshot
+  {
+    Snapshot out;
+    if (!enabled()) return out;
+
+    detail::Registry                &shared = detail::registry();
+    const std::lock_guard<std::mutex> lock{shared.mutex};
+    out = shared.retired;
+    for (const detail::Block *block{shared.head}; block != nullptr; block = block->next)
+      detail::accumulate(*block, out);
+    return out;
+  }
+} // namespace kc::telemetry
+
+// Expanded once, at namespace scope of a single translation unit, replaces the global operator
+// new to count allocations into Counter::Allocations. GCC takes the free of a pointer from the
+// replaced operator new for a mismatch when both are visible, hence the pragmas.
+#if defined(KC_INSTRUMENTATION)
+#define KC_TELEMETRY_ALLOCATION_HOOKS()                                                     \
+  void *operator new(const std::size_t size)                                                \
+  {                                                                                         \
+    ::kc::telemetry::count(::kc::telemetry::Counter::Allocations);                         \
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) return pointer;                  \
+    throw std::bad_alloc{};                                                                 \
+  }                                                                                         \
+  _Pragma("GCC diagnostic push")                                                            \
+  _Pragma("GCC diagnostic ignored \"-Wmismatched-new-delete\"")                             \
+  void operator delete(void *pointer) noexcept { std::free(pointer); }                      \
+  void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }         \
+  _Pragma("GCC diagnostic pop")
+#else
+#define KC_TELEMETRY_ALLOCATION_HOOKS() static_assert(true, "")
+#endif
+
+#endif // KC_TELEMETRY_HPP_
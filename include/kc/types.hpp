@@ -7,12 +7,14 @@
 
 namespace kc
 {
-  template<std::size_t N>
-  struct Vector : public Eigen::Vector<double, N>
+  // Kinematics are templated on the scalar type T: double by default, float for the
+  // mixed-precision paths and ceres::Jet for automatic differentiation.
+  template<std::size_t N, class T = double>
+  struct Vector : public Eigen::Vector<T, N>
   {
-    using Eigen::Vector<double, N>::Vector; // Inherits Eigen::Vector Constructors
+    using Eigen::Vector<T, N>::Vector; // Inherits Eigen::Vector Constructors
     
-    Vector(const double *const data) : Eigen::Vector<double, N>{data} {}
+    Vector(const T *const data) : Eigen::Vector<T, N>{data} {}
 
     friend auto operator>>(std::ifstream &istrm, Vector &vector) -> std::ifstream &
     {
@@ -22,8 +24,37 @@ namespace kc
     }
   };
 
-  using PositionVector       = Vector<3>;
-  using TransformationMatrix = Eigen::Matrix<double, 4, 4>;
+  template<class T>
+  using PositionVectorT = Vector<3, T>;
+  template<class T>
+  using TransformationMatrixT = Eigen::Matrix<T, 4, 4>;
+  template<class T>
+  using HomogeneousVectorT = Eigen::Matrix<T, 4, 1>;
+  template<class T>
+  using LinkJacobianT = Eigen::Matrix<T, 3, 4>;
+
+  // Keeps a parameter out of template argument deduction (std::type_identity_t of C++20), so
+  // that kinematics templated on T take T from the DH parameters and convert the joint angles.
+  template<class T>
+  struct TypeIdentity
+  {
+    using type = T;
+  };
+  template<class T>
+  using NonDeduced = typename TypeIdentity<T>::type;
+
+  // Arithmetic of a batched evaluation: double throughout, or float kinematics with double
+  // accumulation where the accuracy guard of kc::evaluate allows it
+  enum class Precision
+  {
+    Double,
+    Mixed
+  };
+
+  using PositionVector       = PositionVectorT<double>;
+  using TransformationMatrix = TransformationMatrixT<double>;
+  using HomogeneousVector    = HomogeneousVectorT<double>;
+  using LinkJacobian         = LinkJacobianT<double>;
 } // namespace kc
 
 #endif // KC_TYPES_HPP_
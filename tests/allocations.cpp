@@ -0,0 +1,198 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  std::atomic<std::size_t> allocations{0};
+} // namespace
+
+// Eigen::internal::aligned_malloc calls std::malloc directly, out of reach of operator new: with
+// EIGEN_RUNTIME_NO_MALLOC, Eigen checks each of its heap allocations against
+// set_is_malloc_allowed, and the failed checks are counted as allocations, also under NDEBUG.
+// Both macros change the Eigen inline functions, hence the executable of its own.
+#define EIGEN_RUNTIME_NO_MALLOC
+#define eigen_assert(x) (static_cast<bool>(x) ? void() : void(allocations.fetch_add(1, std::memory_order_relaxed)))
+
+#include "kc/BatchCostFunction.hpp"
+#include "kc/CostFunction.hpp"
+#include "kc/io.hpp"
+#include "kc/robots.hpp"
+
+#include "catch2/catch.hpp"
+
+// The Evaluate of the residual blocks, with and without Jacobians, runs on fixed-size stack
+// storage: counted by the operator new and operator new[] replaced below (plain, aligned and
+// nothrow) and by Eigen itself, it makes no heap allocation, including the calls that refill the
+// Robot::cached_angles cache of the thread.
+namespace
+{
+  using KUKA = kc::robots::KUKA;
+
+  constexpr std::size_t N = KUKA::N;
+  constexpr std::size_t B = 16;
+
+  struct Parameters
+  {
+    double              a[N], alpha[N], d[N], theta[N];
+    const double       *blocks[4]{a, alpha, d, theta};
+    std::vector<double> jacobian[4];
+    double             *jacobians[4]{};
+
+    Parameters(const std::size_t residuals, std::mt19937 &generator)
+    {
+      std::uniform_real_distribution<double> length{0., 0.5}, angle{0., 2. * M_PI};
+      for (std::size_t link{}; link < N; ++link)
+      {
+        a[link]     = length(generator);
+        alpha[link] = angle(generator);
+        d[link]     = length(generator);
+        theta[link] = angle(generator);
+      }
+      for (std::size_t block{}; block < 4; ++block)
+      {
+        jacobian[block].resize(residuals * N);
+        jacobians[block] = jacobian[block].data();
+      }
+    }
+
+    // New DH angles, so that the next Evaluate recomputes their sines and cosines
+    void perturb()
+    {
+      for (std::size_t link{}; link < N; ++link)
+      {
+        alpha[link] += 1e-3;
+        theta[link] -= 1e-3;
+      }
+    }
+  };
+
+  // Allocations made by each call of evaluate(call), for call in [0, calls). The calls run on a
+  // new thread, so the first one finds the Robot::cached_angles cache of the thread empty.
+  template<class Evaluate>
+  auto count_allocations(const std::size_t calls, Evaluate &&evaluate) -> std::vector<std::size_t>
+  {
+    std::vector<std::size_t> out(calls);
+    std::thread{[&] {
+      for (std::size_t call{}; call < calls; ++call)
+      {
+        const std::size_t before = allocations.load(std::memory_order_relaxed);
+        Eigen::internal::set_is_malloc_allowed(false);
+        evaluate(call);
+        Eigen::internal::set_is_malloc_allowed(true);
+        out[call] = allocations.load(std::memory_order_relaxed) - before;
+      }
+    }}.join();
+    return out;
+  }
+} // namespace
+
+// Counts every heap allocation of the process made through operator new. GCC takes the free of a
+// pointer from the replaced operator new for a mismatch when both are visible (see
+// KC_TELEMETRY_ALLOCATION_HOOKS).
+namespace
+{
+  auto allocate(const std::size_t size) noexcept -> void *
+  {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+  }
+
+  auto allocate(const std::size_t size, const std::align_val_t alignment) noexcept -> void *
+  {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t bytes = std::size_t(alignment);
+    return std::aligned_alloc(bytes, (size + bytes - 1) / bytes * bytes + (size == 0 ? bytes : 0));
+  }
+} // namespace
+
+void *operator new(const std::size_t size)
+{
+  if (void *pointer = allocate(size)) return pointer;
+  throw std::bad_alloc{};
+}
+void *operator new[](const std::size_t size)
+{
+  if (void *pointer = allocate(size)) return pointer;
+  throw std::bad_alloc{};
+}
+void *operator new(const std::size_t size, const std::align_val_t alignment)
+{
+  if (void *pointer = allocate(size, alignment)) return pointer;
+  throw std::bad_alloc{};
+}
+void *operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+  if (void *pointer = allocate(size, alignment)) return pointer;
+  throw std::bad_alloc{};
+}
+void *operator new(const std::size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+void *operator new[](const std::size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+void *operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t &) noexcept { return allocate(size, alignment); }
+void *operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t &) noexcept { return allocate(size, alignment); }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { std::free(pointer); }
+#pragma GCC diagnostic pop
+
+TEST_CASE("CostFunction::Evaluate does not allocate", "[allocations]")
+{
+  std::mt19937                 generator{1};
+  Parameters                   p{3, generator};
+  const KUKA::JointAngles      q = KUKA::JointAngles::Random();
+  const kc::CostFunction<KUKA> cost{q, kc::PositionVector{0.1, 0.2, 0.3}, 2.};
+  double                       residuals[3];
+
+  double *partial[4] = {p.jacobians[0], nullptr, p.jacobians[2], nullptr};
+
+  // Without and with Jacobians, at the parameters of the previous call (cache hit) or new ones
+  const std::vector<std::size_t> counts = count_allocations(6, [&](const std::size_t call) {
+    if (call == 2 || call == 4) p.perturb();
+    cost.Evaluate(p.blocks, residuals, call == 5 ? partial : (call % 2 == 0 ? nullptr : p.jacobians));
+  });
+  for (const std::size_t count : counts)
+    REQUIRE(count == 0);
+}
+
+TEST_CASE("BatchCostFunction::Evaluate does not allocate", "[allocations]")
+{
+  std::mt19937        generator{2};
+  Parameters          p{3 * B, generator};
+  kc::Columns<N>      joint_angles;
+  kc::Columns<3>      xyz;
+  std::vector<double> weights(B, 0.5);
+  joint_angles.resize(B);
+  xyz.resize(B);
+  std::uniform_real_distribution<double> value{-M_PI, M_PI};
+  for (std::size_t i{}; i < N * B; ++i)
+    joint_angles.data()[i] = value(generator);
+  for (std::size_t i{}; i < 3 * B; ++i)
+    xyz.data()[i] = value(generator);
+
+  const kc::BatchCostFunction<KUKA, B> cost{joint_angles.data(), xyz.data(), B, weights.data()};
+  double                               residuals[3 * B];
+
+  double *partial[4] = {nullptr, p.jacobians[1], nullptr, p.jacobians[3]};
+
+  const std::vector<std::size_t> counts = count_allocations(6, [&](const std::size_t call) {
+    if (call == 2 || call == 4) p.perturb();
+    cost.Evaluate(p.blocks, residuals, call == 5 ? partial : (call % 2 == 0 ? nullptr : p.jacobians));
+  });
+  for (const std::size_t count : counts)
+    REQUIRE(count == 0);
+}
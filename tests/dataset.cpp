@@ -0,0 +1,93 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "kc/Dataset.hpp"
+#include "kc/io.hpp"
+
+#include "catch2/catch.hpp"
+
+// kc::Dataset round trip, and headers that must be rejected before any column is read
+namespace
+{
+  constexpr std::size_t N       = 3;
+  constexpr std::size_t samples = 10;
+
+  auto write(const std::string &filename) -> kc::LoadStatus
+  {
+    kc::Columns<N> joint_angles;
+    kc::Columns<3> xyz;
+    joint_angles.resize(samples);
+    xyz.resize(samples);
+    for (std::size_t i{}; i < N * samples; ++i)
+      joint_angles.data()[i] = double(i);
+    for (std::size_t i{}; i < 3 * samples; ++i)
+      xyz.data()[i] = -double(i);
+    return kc::write_dataset<N>(filename, joint_angles, xyz);
+  }
+
+  void patch(const std::string &filename, const kc::DatasetHeader &header)
+  {
+    std::fstream file{filename, std::ios::binary | std::ios::in | std::ios::out};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  }
+
+  auto header(const std::string &filename) -> kc::DatasetHeader
+  {
+    kc::DatasetHeader out;
+    std::ifstream     file{filename, std::ios::binary};
+    file.read(reinterpret_cast<char *>(&out), sizeof(out));
+    return out;
+  }
+} // namespace
+
+TEST_CASE("Dataset reads back the written columns", "[dataset]")
+{
+  const std::string filename = "dataset_roundtrip.kcd";
+  REQUIRE(write(filename));
+
+  kc::Dataset<N> dataset;
+  REQUIRE(dataset.open(filename));
+  REQUIRE(dataset.samples() == samples);
+  REQUIRE(dataset.joint_angles().column(1)[2] == double(samples + 2));
+  REQUIRE(dataset.xyz().column(2)[samples - 1] == -double(3 * samples - 1));
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("Dataset rejects sample counts that do not match the file size", "[dataset]")
+{
+  const std::string filename = "dataset_samples.kcd";
+  REQUIRE(write(filename));
+  const kc::DatasetHeader written = header(filename);
+
+  kc::DatasetHeader crafted = written;
+  SECTION("one sample too many") { crafted.samples = samples + 1; }
+  SECTION("one sample too few") { crafted.samples = samples - 1; }
+  // (samples + 2^60) * 48 bytes wraps around to the size of samples rows
+  SECTION("count wrapping the size") { crafted.samples = samples + (std::uint64_t(1) << 60); }
+
+  patch(filename, crafted);
+  kc::Dataset<N> dataset;
+  const kc::LoadStatus status = dataset.open(filename, false);
+  REQUIRE(status.error == kc::LoadError::Format);
+  REQUIRE(dataset.samples() == 0);
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("Dataset rejects other versions and joint counts", "[dataset]")
+{
+  const std::string filename = "dataset_header.kcd";
+  REQUIRE(write(filename));
+
+  kc::Dataset<N + 1> wrong_joints;
+  REQUIRE(wrong_joints.open(filename).error == kc::LoadError::Format);
+
+  kc::DatasetHeader old = header(filename);
+  old.version           = 1;
+  patch(filename, old);
+  kc::Dataset<N> dataset;
+  REQUIRE(dataset.open(filename).error == kc::LoadError::Format);
+  std::remove(filename.c_str());
+}
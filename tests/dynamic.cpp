@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "kc/DynamicRobot.hpp"
+#include "kc/robots.hpp"
+
+#include "catch2/catch.hpp"
+
+// kc::DynamicRobot on the generic path against the static kernels of the same chain
+namespace
+{
+  using Stanford = kc::robots::Stanford;
+
+  constexpr std::size_t N = Stanford::N;
+
+  struct Parameters
+  {
+    double        a[N], alpha[N], d[N], theta[N];
+    const double *blocks[4]{a, alpha, d, theta};
+
+    explicit Parameters(std::mt19937 &generator)
+    {
+      std::uniform_real_distribution<double> length{0., 0.5}, angle{0., 2. * M_PI};
+      for (std::size_t link{}; link < N; ++link)
+      {
+        a[link]     = length(generator);
+        alpha[link] = angle(generator);
+        d[link]     = length(generator);
+        theta[link] = angle(generator);
+      }
+    }
+  };
+} // namespace
+
+TEST_CASE("DynamicRobot rejects a chain without links", "[dynamic]")
+{
+  REQUIRE_THROWS_AS(kc::DynamicRobot{{}}, std::invalid_argument);
+}
+
+TEST_CASE("DynamicRobot generic path matches Robot", "[dynamic]")
+{
+  std::mt19937                generator{11};
+  const Parameters            p{generator};
+  const kc::DynamicRobot      robot{{kc::LinkType::Revolute, kc::LinkType::Revolute, kc::LinkType::Prismatic,
+                                     kc::LinkType::Revolute, kc::LinkType::Revolute, kc::LinkType::Revolute},
+                                    false};
+  kc::DynamicRobot::Workspace workspace = robot.workspace();
+  REQUIRE(!robot.is_static());
+
+  for (int i{}; i < 20; ++i)
+  {
+    const Stanford::JointAngles      q = Stanford::JointAngles::Random() * M_PI;
+    kc::DynamicRobot::JacobianMatrix jacobian;
+    const kc::PositionVector         xyz = robot.fk_jacobian(p.a, p.alpha, p.d, p.theta, q, jacobian, workspace);
+    REQUIRE((xyz - Stanford::fk(p.a, p.alpha, p.d, p.theta, q)).cwiseAbs().maxCoeff() < 1e-12);
+    REQUIRE((jacobian - Stanford::jacobian(p.a, p.alpha, p.d, p.theta, q)).cwiseAbs().maxCoeff() < 1e-12);
+  }
+}
+
+TEST_CASE("DynamicCostFunction can be shared and evaluated concurrently", "[dynamic]")
+{
+  std::mt19937           generator{12};
+  const Parameters       p{generator};
+  const kc::DynamicRobot robot{{kc::LinkType::Revolute, kc::LinkType::Revolute, kc::LinkType::Prismatic,
+                                kc::LinkType::Revolute, kc::LinkType::Revolute, kc::LinkType::Revolute},
+                               false};
+  const Stanford::JointAngles    q = Stanford::JointAngles::Random() * M_PI;
+  const kc::PositionVector       y{0.1, -0.2, 0.3};
+  const kc::DynamicCostFunction  cost{robot, q, y};
+  const Stanford::JacobianMatrix expected = Stanford::jacobian(p.a, p.alpha, p.d, p.theta, q);
+
+  constexpr std::size_t    threads = 4, calls = 200;
+  std::vector<double>      errors(threads);
+  std::vector<std::thread> pool;
+  for (std::size_t thread{}; thread < threads; ++thread)
+    pool.emplace_back([&, thread] {
+      std::vector<double> jacobian(4 * 3 * N);
+      double             *jacobians[4] = {&jacobian[0], &jacobian[3 * N], &jacobian[6 * N], &jacobian[9 * N]};
+      double              residuals[3];
+      for (std::size_t call{}; call < calls; ++call)
+      {
+        cost.Evaluate(p.blocks, residuals, jacobians);
+        for (std::size_t block{}; block < 4; ++block)
+          for (std::size_t row{}; row < 3; ++row)
+            for (std::size_t link{}; link < N; ++link)
+              errors[thread] = std::max(errors[thread], std::abs(jacobians[block][row * N + link] - expected(Eigen::Index(row), Eigen::Index(4 * link + block))));
+      }
+    });
+  for (std::thread &thread : pool)
+    thread.join();
+
+  for (const double error : errors)
+    REQUIRE(error < 1e-12);
+}
@@ -0,0 +1,77 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include "kc/evaluate.hpp"
+#include "kc/io.hpp"
+#include "kc/robots.hpp"
+
+#include "catch2/catch.hpp"
+
+// kc::evaluate on positions generated by the same parameters, shifted by a known offset
+namespace
+{
+  using Stanford = kc::robots::Stanford;
+
+  constexpr std::size_t N       = Stanford::N;
+  constexpr std::size_t samples = 5000;
+
+  struct Fixture
+  {
+    double         a[N]{0., 0.1, 0., 0., 0., 0.}, alpha[N]{M_PI_2, M_PI_2, 0., M_PI_2, M_PI_2, 0.};
+    double         d[N]{0.4, 0.15, 0.3, 0., 0., 0.1}, theta[N]{0., M_PI_2, 0., 0., M_PI, 0.};
+    kc::Columns<N> joint_angles;
+    kc::Columns<3> xyz;
+
+    explicit Fixture(const double offset)
+    {
+      std::mt19937                           generator{5};
+      std::uniform_real_distribution<double> angle{-M_PI, M_PI};
+      joint_angles.resize(samples);
+      xyz.resize(samples);
+      for (std::size_t i{}; i < N * samples; ++i)
+        joint_angles.data()[i] = angle(generator);
+      Stanford::fk_batch(a, alpha, d, theta, joint_angles.data(), samples, xyz.data());
+      for (std::size_t i{}; i < samples; ++i)
+        xyz.data()[i] -= offset; // x of every sample
+    }
+  };
+} // namespace
+
+TEST_CASE("evaluate reports a constant offset", "[evaluate]")
+{
+  const Fixture         fixture{1e-3};
+  kc::EvaluationOptions options;
+  options.num_threads = 4;
+
+  const kc::Evaluation evaluation = kc::evaluate<Stanford>(fixture.a, fixture.alpha, fixture.d, fixture.theta,
+                                                           fixture.joint_angles, fixture.xyz, 0, samples, options);
+  REQUIRE(evaluation.samples == samples);
+  REQUIRE(evaluation.rmse == Approx(1e-3).epsilon(1e-6));
+  REQUIRE(evaluation.bias.x() == Approx(1e-3).epsilon(1e-6));
+  REQUIRE(std::abs(evaluation.bias.y()) < 1e-12);
+  REQUIRE(evaluation.p50 == Approx(1e-3).epsilon(1e-6));
+
+  std::size_t binned{};
+  for (const std::size_t count : evaluation.histogram)
+    binned += count;
+  REQUIRE(binned == samples);
+}
+
+TEST_CASE("report prints an evaluation without histogram bins", "[evaluate]")
+{
+  const Fixture         fixture{1e-3};
+  kc::EvaluationOptions options;
+  options.bins = 0;
+
+  const kc::Evaluation evaluation = kc::evaluate<Stanford>(fixture.a, fixture.alpha, fixture.d, fixture.theta,
+                                                           fixture.joint_angles, fixture.xyz, 0, samples, options);
+  REQUIRE(evaluation.histogram.empty());
+
+  std::ostringstream    out;
+  std::streambuf *const previous = std::cout.rdbuf(out.rdbuf());
+  kc::report(evaluation);
+  std::cout.rdbuf(previous);
+  REQUIRE(out.str().find("RMSE [m]") != std::string::npos);
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "kc/Robot.hpp"
+#include "kc/evaluate.hpp"
+#include "kc/robots.hpp"
+#include "kc/simd.hpp"
+
+#include "catch2/catch.hpp"
+
+// Robot::fk_batch against Robot::fk: within a few double ulps of the reach per link (as
+// detail::single_precision_bound for float), over counts that leave a scalar tail.
+namespace
+{
+  template<class Robot>
+  struct Batch
+  {
+    static constexpr std::size_t N = Robot::N;
+
+    double              a[N], alpha[N], d[N], theta[N];
+    std::size_t         count;
+    std::vector<double> q_soa, xyz; // xyz from fk
+    double              reach{};    // farthest position
+
+    Batch(const std::size_t count, std::mt19937 &generator) : count{count}, q_soa(N * count), xyz(3 * count)
+    {
+      std::uniform_real_distribution<double> length{0., 0.5}, angle{0., 2. * M_PI}, joint{-M_PI, M_PI};
+      for (std::size_t link{}; link < N; ++link)
+      {
+        a[link]     = length(generator);
+        alpha[link] = angle(generator);
+        d[link]     = length(generator);
+        theta[link] = angle(generator);
+      }
+      for (double &q : q_soa)
+        q = joint(generator);
+
+      typename Robot::JointAngles q;
+      for (std::size_t sample{}; sample < count; ++sample)
+      {
+        for (std::size_t joint{}; joint < N; ++joint)
+          q[joint] = q_soa[joint * count + sample];
+        const kc::PositionVector position = Robot::fk(a, alpha, d, theta, q);
+        for (std::size_t row{}; row < 3; ++row)
+          xyz[row * count + sample] = position[row];
+        reach = std::max(reach, position.norm());
+      }
+    }
+
+    // 2 N double rounding errors of the reach, the double counterpart of single_precision_bound
+    [[nodiscard]] auto double_bound() const -> double
+    {
+      double links{};
+      for (std::size_t link{}; link < N; ++link)
+        links += std::abs(a[link]) + std::abs(d[link]);
+      return 2. * double(N) * DBL_EPSILON * std::max(links, reach);
+    }
+  };
+
+  template<class Robot>
+  auto counts() -> std::vector<std::size_t>
+  {
+    constexpr std::size_t W = kc::simd::lanes<double>, F = kc::simd::lanes<float>;
+    return {1, W - 1, W, 3 * W + 5, F - 1, 3 * F + 5, 1000};
+  }
+
+  template<class T>
+  auto max_difference(const std::vector<T> &lhs, const std::vector<double> &rhs) -> double
+  {
+    double out{};
+    for (std::size_t i{}; i < rhs.size(); ++i)
+      out = std::max(out, std::abs(double(lhs[i]) - rhs[i]));
+    return out;
+  }
+} // namespace
+
+TEMPLATE_TEST_CASE("Robot::fk_batch matches Robot::fk", "[fk_batch]",
+                   kc::robots::ThreeR, kc::robots::Stanford, kc::robots::KUKA)
+{
+  std::mt19937 generator{21};
+  for (const std::size_t count : counts<TestType>())
+  {
+    const Batch<TestType> batch{count, generator};
+    std::vector<double>   xyz(3 * count);
+    TestType::fk_batch(batch.a, batch.alpha, batch.d, batch.theta, batch.q_soa.data(), count, xyz.data());
+    INFO("count " << count);
+    REQUIRE(max_difference(xyz, batch.xyz) <= batch.double_bound());
+  }
+}
+
+TEMPLATE_TEST_CASE("Robot::fk_batch reads and writes strided columns", "[fk_batch]",
+                   kc::robots::ThreeR, kc::robots::Stanford, kc::robots::KUKA)
+{
+  constexpr std::size_t N = TestType::N;
+
+  std::mt19937 generator{22};
+  for (const std::size_t count : counts<TestType>())
+  {
+    // Samples [offset, offset + count) of columns of rows samples
+    const std::size_t     offset = 3, rows = count + 11;
+    const Batch<TestType> batch{count, generator};
+    std::vector<double>   q_soa(N * rows, 100.), xyz(3 * rows, -1.);
+    for (std::size_t joint{}; joint < N; ++joint)
+      std::copy_n(batch.q_soa.data() + joint * count, count, q_soa.data() + joint * rows + offset);
+
+    TestType::fk_batch(batch.a, batch.alpha, batch.d, batch.theta, q_soa.data() + offset, rows, count, xyz.data() + offset, rows);
+    INFO("count " << count);
+    double error{};
+    for (std::size_t row{}; row < 3; ++row)
+      for (std::size_t sample{}; sample < rows; ++sample)
+      {
+        const double value = xyz[row * rows + sample];
+        if (sample < offset || sample >= offset + count)
+          REQUIRE(value == -1.); // outside the range: untouched
+        else
+          error = std::max(error, std::abs(value - batch.xyz[row * count + sample - offset]));
+      }
+    REQUIRE(error <= batch.double_bound());
+  }
+}
+
+TEMPLATE_TEST_CASE("Robot::fk_batch<double, float> stays within the float bound", "[fk_batch]",
+                   kc::robots::ThreeR, kc::robots::Stanford, kc::robots::KUKA)
+{
+  std::mt19937 generator{23};
+  for (const std::size_t count : counts<TestType>())
+  {
+    const Batch<TestType> batch{count, generator};
+    std::vector<double>   xyz(3 * count);
+    TestType::template fk_batch<double, float>(batch.a, batch.alpha, batch.d, batch.theta, batch.q_soa.data(), count, xyz.data());
+    INFO("count " << count);
+    REQUIRE(max_difference(xyz, batch.xyz) <= kc::detail::single_precision_bound<TestType>(batch.a, batch.d, batch.reach));
+  }
+}
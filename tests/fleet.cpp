@@ -0,0 +1,131 @@
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "kc/Fleet.hpp"
+#include "kc/ThreadPool.hpp"
+
+#include "catch2/catch.hpp"
+
+// kc::load_manifest on manifests breaking one rule each, and failing jobs and tasks in
+// kc::run_fleet and kc::ThreadPool
+namespace
+{
+  const std::string job = "[arm]\n"
+                          "robot        = 3R\n"
+                          "joint_angles = Q.txt\n"
+                          "positions    = P.txt\n"
+                          "a            = 0.9 0.4 1.9\n"
+                          "alpha        = 0 0 0\n"
+                          "d            = 0 0 0\n"
+                          "theta        = 0 0 0\n";
+
+  auto load(const std::string &manifest, std::vector<kc::FleetJob> &jobs) -> kc::LoadStatus
+  {
+    const std::string filename = "fleet_test.manifest";
+    std::ofstream{filename} << manifest;
+    const kc::LoadStatus status = kc::load_manifest(filename, jobs);
+    std::remove(filename.c_str());
+    return status;
+  }
+} // namespace
+
+TEST_CASE("load_manifest reads a job", "[fleet]")
+{
+  std::vector<kc::FleetJob> jobs;
+  REQUIRE(load("# comment\n\n" + job + "constant = alpha d # trailing comment\ntraining_fraction = 1\n", jobs));
+  REQUIRE(jobs.size() == 1);
+  REQUIRE(jobs[0].name == "arm");
+  REQUIRE(jobs[0].robot == "3R");
+  REQUIRE(jobs[0].joint_angles == "Q.txt");
+  REQUIRE(jobs[0].a == std::vector<double>{0.9, 0.4, 1.9});
+  REQUIRE(jobs[0].constant == std::vector<std::string>{"alpha", "d"});
+  REQUIRE(jobs[0].training_fraction == 1.);
+  REQUIRE(jobs[0].max_num_iterations == 50);
+}
+
+TEST_CASE("load_manifest rejects malformed lines with their row", "[fleet]")
+{
+  std::string manifest;
+  std::size_t row{};
+  SECTION("unterminated section name") { manifest = "[arm\n", row = 1; }
+  SECTION("line without =") { manifest = job + "robot 3R\n", row = 9; }
+  SECTION("key before any section") { manifest = "robot = 3R\n" + job, row = 1; }
+  SECTION("unknown robot") { manifest = job + "robot = 4R\n", row = 9; }
+  SECTION("invalid number") { manifest = job + "d = 0 x 0\n", row = 9; }
+  SECTION("unknown parameter block") { manifest = job + "constant = a beta\n", row = 9; }
+  SECTION("training_fraction of 0") { manifest = job + "training_fraction = 0\n", row = 9; }
+  SECTION("training_fraction over 1") { manifest = job + "training_fraction = 1.5\n", row = 9; }
+  SECTION("max_num_iterations of 0") { manifest = job + "max_num_iterations = 0\n", row = 9; }
+  SECTION("max_num_iterations not a number") { manifest = job + "max_num_iterations = many\n", row = 9; }
+  SECTION("unknown key") { manifest = job + "beta = 0 0 0\n", row = 9; }
+
+  std::vector<kc::FleetJob> jobs;
+  const kc::LoadStatus      status = load(manifest, jobs);
+  REQUIRE(status.error == kc::LoadError::Parse);
+  REQUIRE(status.row == row);
+  REQUIRE(status.message.find(":" + std::to_string(row) + ": ") != std::string::npos);
+}
+
+TEST_CASE("load_manifest rejects incomplete jobs", "[fleet]")
+{
+  std::string manifest;
+  SECTION("no robot") { manifest = "[arm]\ndataset = arm.kcd\na = 0\nalpha = 0\nd = 0\ntheta = 0\n"; }
+  SECTION("no samples") { manifest = "[arm]\nrobot = 3R\na = 0 0 0\nalpha = 0 0 0\nd = 0 0 0\ntheta = 0 0 0\n"; }
+  SECTION("positions without joint angles") { manifest = "[arm]\nrobot = 3R\npositions = P.txt\na = 0 0 0\nalpha = 0 0 0\nd = 0 0 0\ntheta = 0 0 0\n"; }
+  SECTION("both a dataset and text files") { manifest = job + "dataset = arm.kcd\n"; }
+  SECTION("no initial theta") { manifest = "[arm]\nrobot = 3R\ndataset = arm.kcd\na = 0 0 0\nalpha = 0 0 0\nd = 0 0 0\n"; }
+
+  std::vector<kc::FleetJob> jobs;
+  const kc::LoadStatus      status = load(manifest, jobs);
+  REQUIRE(status.error == kc::LoadError::Format);
+  REQUIRE(status.message.find("[arm]") != std::string::npos);
+}
+
+TEST_CASE("load_manifest reports a missing manifest", "[fleet]")
+{
+  std::vector<kc::FleetJob> jobs;
+  REQUIRE(kc::load_manifest("no_such.manifest", jobs).error == kc::LoadError::Open);
+}
+
+TEST_CASE("run_fleet reports failing jobs and carries on", "[fleet]")
+{
+  std::vector<kc::FleetJob> jobs;
+  REQUIRE(load(job + "\n[other]\nrobot = Stanford\ndataset = missing.kcd\na = 0 0 0 0 0 0\nalpha = 0 0 0 0 0 0\n"
+                     "d = 0 0 0 0 0 0\ntheta = 0 0 0 0 0 0\n", jobs));
+  jobs[0].a.pop_back(); // 2 values for 3 links
+
+  kc::FleetOptions options;
+  options.num_threads = 2;
+  std::ostringstream     out;
+  const kc::FleetSummary summary = kc::run_fleet(jobs, options, out);
+  REQUIRE(summary.jobs == 2);
+  REQUIRE(summary.failed == 2);
+
+  std::vector<std::string> lines;
+  std::istringstream       in{out.str()};
+  for (std::string line; std::getline(in, line);)
+    lines.push_back(line);
+  REQUIRE(lines.size() == 3);
+  for (std::size_t i{}; i < 2; ++i)
+    REQUIRE(lines[i].find("\"ok\":false,\"error\":") != std::string::npos);
+  REQUIRE(lines[2].find("{\"fleet\":{\"jobs\":2,\"failed\":2,") == 0);
+}
+
+TEST_CASE("ThreadPool survives throwing tasks", "[fleet]")
+{
+  std::atomic<int> completed{0};
+  kc::ThreadPool   pool(3);
+  for (int i{}; i < 20; ++i)
+    pool.submit([&, i] {
+      if (i % 4 == 0) throw std::runtime_error("task failed");
+      ++completed;
+    });
+  pool.wait();
+  REQUIRE(pool.failed() == 5);
+  REQUIRE(completed == 15);
+}
@@ -0,0 +1,93 @@
+#include <cmath>
+#include <random>
+
+#include "kc/NativeCalibrator.hpp"
+#include "kc/identifiability.hpp"
+#include "kc/io.hpp"
+#include "kc/robots.hpp"
+
+#include "catch2/catch.hpp"
+
+// kc::identifiability on long and short training sets
+namespace
+{
+  using KUKA   = kc::robots::KUKA;
+  using ThreeR = kc::robots::ThreeR;
+
+  template<class Robot>
+  void random_joint_angles(const std::size_t samples, kc::Columns<Robot::N> &joint_angles)
+  {
+    std::mt19937                           generator{9};
+    std::uniform_real_distribution<double> angle{-M_PI, M_PI};
+    joint_angles.resize(samples);
+    for (std::size_t i{}; i < Robot::N * samples; ++i)
+      joint_angles.data()[i] = angle(generator);
+  }
+
+  struct KUKAParameters
+  {
+    // clang-format off
+    double a[7]     = {      0,      0,      0,      0,      0,      0,     0 };
+    double alpha[7] = { M_PI_2, M_PI_2, M_PI_2, M_PI_2, M_PI_2, M_PI_2,     0 };
+    double d[7]     = {   0.34,      0,    0.4,      0,    0.4,      0, 0.126 };
+    double theta[7] = {   M_PI,   M_PI,      0,   M_PI,      0,   M_PI,     0 };
+    // clang-format on
+  };
+
+  auto fixed_count(const kc::Identifiability &identifiability) -> std::size_t
+  {
+    std::size_t out{};
+    for (const auto &block : identifiability.fixed)
+      out += block.size();
+    return out;
+  }
+} // namespace
+
+TEST_CASE("identifiability finds the redundant d of parallel axes", "[identifiability]")
+{
+  kc::Columns<ThreeR::N> joint_angles;
+  random_joint_angles<ThreeR>(200, joint_angles);
+  const double a[3]{0.5, 0.4, 0.3}, alpha[3]{0., 0., 0.}, d[3]{0.1, 0.2, 0.3}, theta[3]{0.1, 0.2, 0.3};
+
+  const kc::Identifiability identifiability = kc::identifiability<ThreeR>(a, alpha, d, theta, joint_angles, {{0, 200}});
+  REQUIRE(identifiability.poses == 200);
+  REQUIRE(identifiability.fixed[2].size() == 2); // only d1 + d2 + d3 shows in the positions
+  REQUIRE(identifiability.rank + fixed_count(identifiability) == identifiability.parameters);
+}
+
+TEST_CASE("identifiability handles fewer poses than parameters", "[identifiability]")
+{
+  const KUKAParameters p;
+  kc::Columns<KUKA::N> joint_angles;
+  random_joint_angles<KUKA>(9, joint_angles);
+
+  // 27 Jacobian rows for 28 parameters
+  const kc::Identifiability identifiability = kc::identifiability<KUKA>(p.a, p.alpha, p.d, p.theta, joint_angles, {{0, 9}});
+  REQUIRE(identifiability.poses == 9);
+  REQUIRE(identifiability.rank <= 27);
+  REQUIRE(identifiability.rank + fixed_count(identifiability) == identifiability.parameters);
+  REQUIRE(std::size_t(identifiability.singular_values.size()) == 27);
+  REQUIRE(std::isfinite(identifiability.condition_number()));
+
+  const kc::Identifiability single = kc::identifiability<KUKA>(p.a, p.alpha, p.d, p.theta, joint_angles, {{0, 1}});
+  REQUIRE(single.rank <= 3);
+  REQUIRE(single.rank + fixed_count(single) == single.parameters);
+}
+
+TEST_CASE("NativeCalibrator solves a training set shorter than 4N / 3 samples", "[identifiability]")
+{
+  KUKAParameters       p;
+  kc::Columns<KUKA::N> joint_angles;
+  kc::Columns<3>       xyz;
+  random_joint_angles<KUKA>(12, joint_angles);
+  xyz.resize(12);
+  KUKA::fk_batch(p.a, p.alpha, p.d, p.theta, joint_angles.data(), 12, xyz.data());
+
+  kc::NativeOptions options;
+  options.num_threads = 1;
+  kc::NativeCalibrator<KUKA> calibrator(joint_angles, xyz, p.a, p.alpha, p.d, p.theta, options); // 9 training samples
+  REQUIRE(calibrator.training_samples() == 9);
+  REQUIRE(calibrator.identifiability().rank <= 27);
+  const kc::NativeSummary summary = calibrator.solve();
+  REQUIRE(std::isfinite(summary.final_cost));
+}
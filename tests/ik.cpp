@@ -0,0 +1,140 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "kc/InverseKinematics.hpp"
+#include "kc/io.hpp"
+#include "kc/robots.hpp"
+
+#include "catch2/catch.hpp"
+
+// kc::InverseKinematics: fk -> solve round trips from perturbed seeds, the batched solve against
+// the per-target one, and compensation under the nominal parameters themselves
+namespace
+{
+  // DH parameters of the example robots (see examples/)
+  template<class Robot>
+  struct Parameters;
+
+  template<>
+  struct Parameters<kc::robots::ThreeR>
+  {
+    double a[3]{0.5, 0.4, 0.3}, alpha[3]{0., 0., 0.}, d[3]{0.1, 0.2, 0.3}, theta[3]{0.1, 0.2, 0.3};
+  };
+
+  template<>
+  struct Parameters<kc::robots::Stanford>
+  {
+    double a[6]{0., 0.1, 0., 0., 0., 0.}, alpha[6]{M_PI_2, M_PI_2, 0., M_PI_2, M_PI_2, 0.};
+    double d[6]{0.4, 0.15, 0.3, 0., 0., 0.1}, theta[6]{0., M_PI_2, 0., 0., M_PI, 0.};
+  };
+
+  template<>
+  struct Parameters<kc::robots::KUKA>
+  {
+    // clang-format off
+    double a[7]     = {      0,      0,      0,      0,      0,      0,     0 };
+    double alpha[7] = { M_PI_2, M_PI_2, M_PI_2, M_PI_2, M_PI_2, M_PI_2,     0 };
+    double d[7]     = {   0.34,      0,    0.4,      0,    0.4,      0, 0.126 };
+    double theta[7] = {   M_PI,   M_PI,      0,   M_PI,      0,   M_PI,     0 };
+    // clang-format on
+  };
+
+  // count random joint configurations in [-pi/2, pi/2], away from the joint limits of the
+  // examples, and their positions under p
+  template<class Robot>
+  void configurations(const Parameters<Robot> &p, const std::size_t count, kc::Columns<Robot::N> &q, kc::Columns<3> &xyz)
+  {
+    std::mt19937                           generator{17};
+    std::uniform_real_distribution<double> joint{-M_PI_2, M_PI_2};
+    q.resize(count);
+    xyz.resize(count);
+    for (std::size_t i{}; i < Robot::N * count; ++i)
+      q.data()[i] = joint(generator);
+    Robot::fk_batch(p.a, p.alpha, p.d, p.theta, q.data(), count, xyz.data());
+  }
+} // namespace
+
+TEMPLATE_TEST_CASE("InverseKinematics recovers fk targets from perturbed seeds", "[ik]",
+                   kc::robots::ThreeR, kc::robots::Stanford, kc::robots::KUKA)
+{
+  const Parameters<TestType> p;
+  kc::Columns<TestType::N>   q;
+  kc::Columns<3>             xyz;
+  configurations(p, 250, q, xyz);
+
+  const kc::InverseKinematics<TestType>  ik{p.a, p.alpha, p.d, p.theta};
+  std::mt19937                           generator{18};
+  std::uniform_real_distribution<double> perturbation{-0.02, 0.02};
+  for (std::size_t i{}; i < xyz.rows(); ++i)
+  {
+    typename TestType::JointAngles seed = q.row(i);
+    for (std::size_t joint{}; joint < TestType::N; ++joint)
+      seed[joint] += perturbation(generator);
+
+    const auto solution = ik.solve(xyz.row(i), seed);
+    INFO("target " << i);
+    REQUIRE(solution.converged);
+    REQUIRE(solution.error <= kc::IKOptions{}.tolerance);
+    REQUIRE((TestType::fk(p.a, p.alpha, p.d, p.theta, solution.q) - xyz.row(i)).norm() <= kc::IKOptions{}.tolerance);
+  }
+}
+
+TEST_CASE("InverseKinematics batched solve matches the per-target one", "[ik]")
+{
+  using KUKA = kc::robots::KUKA;
+
+  // A partial last chunk, and seeds off by up to 0.3 rad, so that some targets need several steps
+  const std::size_t      count = 3 * kc::detail::ik_chunk + 17;
+  const Parameters<KUKA> p;
+  kc::Columns<KUKA::N>   q, seeds;
+  kc::Columns<3>         xyz;
+  configurations(p, count, q, xyz);
+  seeds.resize(count);
+  std::mt19937                           generator{19};
+  std::uniform_real_distribution<double> perturbation{-0.3, 0.3};
+  for (std::size_t i{}; i < KUKA::N * count; ++i)
+    seeds.data()[i] = q.data()[i] + perturbation(generator);
+
+  kc::IKOptions options;
+  options.num_threads = 4;
+  const kc::InverseKinematics<KUKA> ik{p.a, p.alpha, p.d, p.theta, options};
+
+  kc::Columns<KUKA::N> out;
+  std::vector<double>  errors(count);
+  const kc::IKSummary  summary = ik.solve(xyz, seeds, out, errors.data());
+  REQUIRE(summary.targets == count);
+  REQUIRE(out.rows() == count);
+
+  std::size_t converged{};
+  int         max_iterations{};
+  for (std::size_t i{}; i < count; ++i)
+  {
+    const auto solution = ik.solve(xyz.row(i), seeds.row(i));
+    REQUIRE(out.row(i) == solution.q);
+    REQUIRE(errors[i] == solution.error);
+    converged += solution.converged ? 1 : 0;
+    max_iterations = std::max(max_iterations, solution.iterations);
+  }
+  REQUIRE(summary.converged == converged);
+  REQUIRE(summary.max_iterations == max_iterations);
+  REQUIRE(max_iterations > 1);
+}
+
+TEST_CASE("InverseKinematics::compensate keeps the commanded angles under the same parameters", "[ik]")
+{
+  using KUKA = kc::robots::KUKA;
+
+  const std::size_t      count = 2 * kc::detail::ik_chunk + 5;
+  const Parameters<KUKA> p;
+  kc::Columns<KUKA::N>   commanded, out;
+  kc::Columns<3>         xyz;
+  configurations(p, count, commanded, xyz);
+
+  const kc::InverseKinematics<KUKA> ik{p.a, p.alpha, p.d, p.theta};
+  const kc::IKSummary               summary = ik.compensate(p.a, p.alpha, p.d, p.theta, commanded, out);
+  REQUIRE(summary.converged == count);
+  REQUIRE(summary.max_iterations == 0);
+  for (std::size_t i{}; i < KUKA::N * count; ++i)
+    REQUIRE(out.data()[i] == commanded.data()[i]);
+}
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "kc/IncrementalCalibrator.hpp"
+#include "kc/io.hpp"
+
+#include "synthetic.hpp"
+
+#include "catch2/catch.hpp"
+
+// kc::IncrementalCalibrator on batches of noise-free synthetic KUKA samples streamed in from the
+// nominal parameters, with the parameters identifiability fixes held constant
+namespace
+{
+  using KUKA = synthetic::KUKA;
+
+  constexpr std::size_t N       = synthetic::N;
+  constexpr std::size_t batch   = 200;
+  constexpr std::size_t batches = 20;
+
+  struct Fixture
+  {
+    kc::Columns<N>        joint_angles;
+    kc::Identifiability   identifiability;
+    synthetic::Parameters truth;
+
+    Fixture()
+    {
+      synthetic::joint_angles(batch * batches, joint_angles);
+      identifiability = synthetic::nominal_identifiability(joint_angles, {{0, batch}});
+      truth           = synthetic::Parameters{identifiability, 5};
+    }
+
+    auto calibrator(const synthetic::Parameters &start, const kc::IncrementalOptions &options = {}) const -> kc::IncrementalCalibrator<KUKA>
+    {
+      kc::IncrementalCalibrator<KUKA> out(start.a, start.alpha, start.d, start.theta, options);
+      for (std::size_t block{}; block < 4; ++block)
+        for (const int link : identifiability.fixed[block])
+          out.set_constant(block, std::size_t(link));
+      return out;
+    }
+  };
+
+  // Rows [i * batch, (i + 1) * batch) of the stream, as the i-th batch would arrive
+  template<std::size_t C>
+  auto slice(const kc::Columns<C> &stream, const std::size_t i) -> kc::Columns<C>
+  {
+    kc::Columns<C> out;
+    out.resize(batch);
+    for (std::size_t c{}; c < C; ++c)
+      std::copy_n(stream.column(c) + i * batch, batch, out.data() + c * batch);
+    return out;
+  }
+
+  auto estimate(const kc::IncrementalCalibrator<KUKA> &calibrator) -> synthetic::Parameters
+  {
+    synthetic::Parameters out;
+    std::copy_n(calibrator.a(), N, out.a);
+    std::copy_n(calibrator.alpha(), N, out.alpha);
+    std::copy_n(calibrator.d(), N, out.d);
+    std::copy_n(calibrator.theta(), N, out.theta);
+    return out;
+  }
+
+  // Folds in every batch of the stream, the first shifted ones from shifted, with an update
+  // after each, and returns the distance to truth after each update.
+  auto stream(kc::IncrementalCalibrator<KUKA> &calibrator, const Fixture &fixture, const kc::Columns<3> &xyz,
+              const kc::Columns<3> &shifted = {}, const std::size_t shifted_batches = 0) -> std::vector<double>
+  {
+    std::vector<double> out;
+    for (std::size_t i{}; i < batches; ++i)
+    {
+      calibrator.add(slice(fixture.joint_angles, i), slice(i < shifted_batches ? shifted : xyz, i));
+      calibrator.update();
+      out.push_back(estimate(calibrator).distance(fixture.truth));
+    }
+    return out;
+  }
+} // namespace
+
+TEST_CASE("IncrementalCalibrator approaches the generating parameters", "[incremental]")
+{
+  const Fixture  fixture;
+  kc::Columns<3> xyz;
+  synthetic::positions(fixture.truth, fixture.joint_angles, xyz);
+
+  kc::IncrementalCalibrator<KUKA> calibrator = fixture.calibrator(synthetic::Parameters{});
+  const std::vector<double>       distances  = stream(calibrator, fixture, xyz);
+  REQUIRE(calibrator.samples() == batch * batches);
+  REQUIRE(distances.front() < 1e-5); // from up to 1e-3 off
+  REQUIRE(distances.back() < distances.front() / 10.);
+  REQUIRE(distances.back() < 1e-6);
+}
+
+TEST_CASE("IncrementalCalibrator with decay < 1 forgets a shifted early batch", "[incremental]")
+{
+  const Fixture  fixture;
+  kc::Columns<3> xyz, shifted;
+  synthetic::positions(fixture.truth, fixture.joint_angles, xyz);
+  synthetic::Parameters moved = fixture.truth;
+  moved.d[2] += 5e-3;
+  synthetic::positions(moved, fixture.joint_angles, shifted);
+
+  kc::IncrementalCalibrator<KUKA> remembering = fixture.calibrator(synthetic::Parameters{});
+  REQUIRE(stream(remembering, fixture, xyz, shifted, 2).back() > 1e-4);
+
+  kc::IncrementalOptions options;
+  options.decay                              = 0.5;
+  kc::IncrementalCalibrator<KUKA> forgetting = fixture.calibrator(synthetic::Parameters{}, options);
+  const std::vector<double>       distances  = stream(forgetting, fixture, xyz, shifted, 2);
+  REQUIRE(distances[1] > 1e-3);
+  REQUIRE(distances.back() < 1e-6);
+}
+
+TEST_CASE("IncrementalCalibrator keeps constant parameters outside the bounds", "[incremental]")
+{
+  Fixture fixture;
+  fixture.truth.theta[6] = -1e-3;
+  kc::Columns<3> xyz;
+  synthetic::positions(fixture.truth, fixture.joint_angles, xyz);
+
+  synthetic::Parameters start;
+  start.theta[6]                             = fixture.truth.theta[6];
+  kc::IncrementalCalibrator<KUKA> calibrator = fixture.calibrator(start);
+  calibrator.set_constant(3, 6);
+  const std::vector<double> distances = stream(calibrator, fixture, xyz);
+  REQUIRE(calibrator.theta()[6] == fixture.truth.theta[6]);
+  REQUIRE(distances.back() < 1e-6);
+}
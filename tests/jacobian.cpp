@@ -0,0 +1,148 @@
+#include <array>
+#include <cmath>
+#include <random>
+#include <utility>
+
+#include "kc/Robot.hpp"
+#include "kc/robots.hpp"
+#include "kc/types.hpp"
+
+#include "catch2/catch.hpp"
+
+// Robot::jacobian and Robot::fk_jacobian, from the shared prefix and suffix products, against the
+// product pre * delta_zeta * post of every link and parameter and against central differences of
+// Robot::fk, on both the angle path and the cached sine / cosine (JointSinCos) path.
+namespace
+{
+  template<class Robot>
+  struct Sample
+  {
+    static constexpr std::size_t N = Robot::N;
+
+    double                      a[N], alpha[N], d[N], theta[N];
+    typename Robot::JointAngles q;
+
+    explicit Sample(std::mt19937 &generator)
+    {
+      std::uniform_real_distribution<double> length{0., 0.5}, angle{0., 2. * M_PI}, joint{-M_PI, M_PI};
+      for (std::size_t link{}; link < N; ++link)
+      {
+        a[link]     = length(generator);
+        alpha[link] = angle(generator);
+        d[link]     = length(generator);
+        theta[link] = angle(generator);
+        q[link]     = joint(generator);
+      }
+    }
+  };
+
+  template<class... Links, std::size_t... Is>
+  auto reference_jacobian(const Sample<kc::Robot<Links...>> &s, std::index_sequence<Is...>) -> typename kc::Robot<Links...>::JacobianMatrix
+  {
+    constexpr std::size_t N = sizeof...(Links);
+
+    const std::array<kc::TransformationMatrix, N>                transforms = {Links::transform(s.a[Is], s.alpha[Is], s.d[Is], s.theta[Is], s.q[Is])...};
+    const std::array<std::array<kc::TransformationMatrix, 4>, N> deltas     = {
+        std::array<kc::TransformationMatrix, 4>{Links::delta_a(s.theta[Is], s.q[Is]),
+                                                Links::delta_alpha(s.alpha[Is], s.theta[Is], s.q[Is]),
+                                                Links::delta_d(),
+                                                Links::delta_theta(s.a[Is], s.alpha[Is], s.theta[Is], s.q[Is])}...};
+
+    typename kc::Robot<Links...>::JacobianMatrix out;
+    for (std::size_t link{}; link < N; ++link)
+    {
+      kc::TransformationMatrix pre = kc::TransformationMatrix::Identity(), post = kc::TransformationMatrix::Identity();
+      for (std::size_t j{}; j < link; ++j)
+        pre = pre * transforms[j];
+      for (std::size_t j{link + 1}; j < N; ++j)
+        post = post * transforms[j];
+      for (std::size_t block{}; block < 4; ++block)
+        out.col(Eigen::Index(4 * link + block)) = (pre * deltas[link][block] * post).template block<3, 1>(0, 3);
+    }
+    return out;
+  }
+
+  template<class Robot>
+  auto reference_jacobian(const Sample<Robot> &s) -> typename Robot::JacobianMatrix
+  {
+    return reference_jacobian(s, std::make_index_sequence<Robot::N>{});
+  }
+
+  template<class Robot>
+  auto finite_differences(Sample<Robot> s, const double step = 1e-6) -> typename Robot::JacobianMatrix
+  {
+    typename Robot::JacobianMatrix out;
+    for (std::size_t link{}; link < Robot::N; ++link)
+    {
+      double *const parameters[4] = {&s.a[link], &s.alpha[link], &s.d[link], &s.theta[link]};
+      for (std::size_t block{}; block < 4; ++block)
+      {
+        const double value = *parameters[block];
+        *parameters[block] = value + step;
+        const kc::PositionVector forward = Robot::fk(s.a, s.alpha, s.d, s.theta, s.q);
+        *parameters[block] = value - step;
+        const kc::PositionVector backward = Robot::fk(s.a, s.alpha, s.d, s.theta, s.q);
+        *parameters[block] = value;
+        out.col(Eigen::Index(4 * link + block)) = (forward - backward) / (2. * step);
+      }
+    }
+    return out;
+  }
+
+  template<class Derived, class Other>
+  auto max_difference(const Eigen::MatrixBase<Derived> &lhs, const Eigen::MatrixBase<Other> &rhs) -> double
+  {
+    return (lhs - rhs).cwiseAbs().maxCoeff();
+  }
+} // namespace
+
+TEMPLATE_TEST_CASE("Robot::jacobian matches pre * delta * post", "[jacobian]",
+                   kc::robots::ThreeR, kc::robots::Stanford, kc::robots::KUKA)
+{
+  std::mt19937 generator{42};
+  for (int i{}; i < 100; ++i)
+  {
+    const Sample<TestType>                 s{generator};
+    const typename TestType::JacobianMatrix reference = reference_jacobian(s);
+
+    REQUIRE(max_difference(TestType::jacobian(s.a, s.alpha, s.d, s.theta, s.q), reference) < 1e-12);
+
+    typename TestType::JacobianMatrix jacobian;
+    const kc::PositionVector          xyz = TestType::fk_jacobian(s.a, s.d, TestType::angles(s.alpha, s.theta), s.q, TestType::joint_sincos(s.q), jacobian);
+    REQUIRE(max_difference(jacobian, reference) < 1e-12);
+    REQUIRE(max_difference(xyz, TestType::fk(s.a, s.alpha, s.d, s.theta, s.q)) < 1e-12);
+  }
+}
+
+TEMPLATE_TEST_CASE("Robot::jacobian matches finite differences of Robot::fk", "[jacobian]",
+                   kc::robots::ThreeR, kc::robots::Stanford, kc::robots::KUKA)
+{
+  std::mt19937 generator{7};
+  for (int i{}; i < 100; ++i)
+  {
+    const Sample<TestType>                 s{generator};
+    const typename TestType::JacobianMatrix numeric = finite_differences(s);
+
+    typename TestType::JacobianMatrix angle_path, sincos_path;
+    TestType::fk_jacobian(s.a, s.alpha, s.d, s.theta, s.q, angle_path);
+    TestType::fk_jacobian(s.a, s.d, TestType::angles(s.alpha, s.theta), s.q, TestType::joint_sincos(s.q), sincos_path);
+    REQUIRE(max_difference(angle_path, numeric) < 1e-8);
+    REQUIRE(max_difference(sincos_path, numeric) < 1e-8);
+  }
+}
+
+TEMPLATE_TEST_CASE("Robot::chain holds the partial products", "[jacobian]",
+                   kc::robots::ThreeR, kc::robots::Stanford, kc::robots::KUKA)
+{
+  std::mt19937           generator{3};
+  const Sample<TestType> s{generator};
+  const auto             products = TestType::chain(s.a, s.alpha, s.d, s.theta, s.q);
+  const kc::TransformationMatrix pose = TestType::fk_pose(s.a, s.alpha, s.d, s.theta, s.q);
+
+  REQUIRE(max_difference(products.prefix[0], kc::TransformationMatrix::Identity()) == 0.);
+  REQUIRE(max_difference(products.prefix[TestType::N], pose) < 1e-12);
+  REQUIRE(max_difference(products.suffix[TestType::N - 1], kc::HomogeneousVector::UnitW()) == 0.);
+  // The end-effector origin is the same from every split of the chain
+  for (std::size_t link{}; link < TestType::N; ++link)
+    REQUIRE(max_difference(products.prefix[link + 1] * products.suffix[link], pose.col(3)) < 1e-12);
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include "kc/NativeCalibrator.hpp"
+#include "kc/evaluate.hpp"
+#include "kc/io.hpp"
+#include "kc/multistart.hpp"
+#include "kc/robots.hpp"
+
+#include "catch2/catch.hpp"
+
+// kc::multi_start on synthetic Stanford samples, from the nominal parameters with theta of the
+// prismatic link a quarter turn out: a single solve from there ends in a local minimum
+namespace
+{
+  using Stanford = kc::robots::Stanford;
+
+  constexpr std::size_t N       = Stanford::N;
+  constexpr std::size_t samples = 2000;
+
+  struct Parameters
+  {
+    double a[N]{0., 0.1, 0., 0., 0., 0.}, alpha[N]{M_PI_2, M_PI_2, 0., M_PI_2, M_PI_2, 0.};
+    double d[N]{0.4, 0.15, 0.3, 0., 0., 0.1}, theta[N]{0., M_PI_2, 0., 0., M_PI, 0.};
+  };
+
+  struct Fixture
+  {
+    kc::Columns<N> joint_angles;
+    kc::Columns<3> xyz;
+    std::size_t    split = std::size_t(double(samples) * kc::NativeOptions{}.training_fraction);
+
+    // Positions of the nominal parameters offset by up to 1 mm and 1 mrad, with 10 um of noise
+    Fixture()
+    {
+      std::mt19937                           generator{3};
+      std::uniform_real_distribution<double> offset{0., 1e-3}, angle{-M_PI, M_PI};
+      std::normal_distribution<double>       noise{0., 1e-5};
+      Parameters                             truth;
+      for (std::size_t link{}; link < N; ++link)
+      {
+        truth.a[link] += offset(generator);
+        truth.alpha[link] += offset(generator);
+        truth.d[link] += offset(generator);
+        truth.theta[link] += offset(generator);
+      }
+      joint_angles.resize(samples);
+      xyz.resize(samples);
+      for (std::size_t i{}; i < N * samples; ++i)
+        joint_angles.data()[i] = angle(generator);
+      Stanford::fk_batch(truth.a, truth.alpha, truth.d, truth.theta, joint_angles.data(), samples, xyz.data());
+      for (std::size_t i{}; i < 3 * samples; ++i)
+        xyz.data()[i] += noise(generator);
+    }
+
+    auto solve(Parameters &p) const -> kc::Evaluation
+    {
+      kc::NativeOptions options;
+      options.num_threads = 1;
+      kc::NativeCalibrator<Stanford> calibrator(joint_angles, xyz, p.a, p.alpha, p.d, p.theta, options);
+      calibrator.solve();
+      return kc::evaluate<Stanford>(p.a, p.alpha, p.d, p.theta, joint_angles, xyz, split, samples);
+    }
+  };
+
+  auto wrong_guess() -> Parameters
+  {
+    Parameters out;
+    out.theta[2] += M_PI / 2.;
+    return out;
+  }
+
+  auto options(const std::size_t threads) -> kc::MultiStartOptions
+  {
+    kc::MultiStartOptions out;
+    out.num_threads = threads;
+    out.starts      = 32;
+    return out;
+  }
+} // namespace
+
+TEST_CASE("multi_start recovers from an angle a quarter turn out", "[multistart]")
+{
+  const Fixture fixture;
+
+  Parameters           correct;
+  const kc::Evaluation reference = fixture.solve(correct);
+
+  Parameters           single = wrong_guess();
+  const kc::Evaluation trapped = fixture.solve(single);
+  REQUIRE(trapped.rmse > 100. * reference.rmse);
+
+  Parameters           p     = wrong_guess();
+  const kc::MultiStart multi = kc::multi_start<Stanford>(p.a, p.alpha, p.d, p.theta, fixture.joint_angles, fixture.xyz, options(1));
+  REQUIRE(multi.candidates.size() == kc::MultiStartOptions{}.survivors);
+  REQUIRE(multi.candidates.front().start != 0);
+  REQUIRE(multi.candidates.front().validation.rmse == Approx(reference.rmse).epsilon(0.01));
+
+  // The best candidate is written back
+  const kc::Evaluation written = kc::evaluate<Stanford>(p.a, p.alpha, p.d, p.theta, fixture.joint_angles, fixture.xyz, fixture.split, samples);
+  REQUIRE(written.rmse == multi.candidates.front().validation.rmse);
+}
+
+TEST_CASE("multi_start gives identical candidates for any thread count", "[multistart]")
+{
+  const Fixture fixture;
+
+  Parameters           serial    = wrong_guess();
+  const kc::MultiStart reference = kc::multi_start<Stanford>(serial.a, serial.alpha, serial.d, serial.theta,
+                                                             fixture.joint_angles, fixture.xyz, options(1));
+  for (const std::size_t threads : {2, 4})
+  {
+    Parameters           p     = wrong_guess();
+    const kc::MultiStart multi = kc::multi_start<Stanford>(p.a, p.alpha, p.d, p.theta, fixture.joint_angles, fixture.xyz, options(threads));
+    INFO(threads << " threads");
+    REQUIRE(multi.rounds == reference.rounds);
+    REQUIRE(multi.probes == reference.probes);
+    REQUIRE(multi.candidates.size() == reference.candidates.size());
+    for (std::size_t i{}; i < reference.candidates.size(); ++i)
+    {
+      const kc::MultiStartCandidate &expected = reference.candidates[i];
+      const kc::MultiStartCandidate &actual   = multi.candidates[i];
+      INFO("candidate " << i);
+      REQUIRE(actual.start == expected.start);
+      REQUIRE(actual.iterations == expected.iterations);
+      REQUIRE(actual.probe_cost == expected.probe_cost);
+      REQUIRE(actual.summary.final_cost == expected.summary.final_cost);
+      REQUIRE(actual.validation.rmse == expected.validation.rmse);
+      REQUIRE(std::memcmp(actual.parameters.data(), expected.parameters.data(), 4 * N * sizeof(double)) == 0);
+    }
+    REQUIRE(std::memcmp(p.theta, serial.theta, sizeof(p.theta)) == 0);
+  }
+}
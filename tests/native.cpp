@@ -0,0 +1,159 @@
+#include <cmath>
+#include <cstring>
+
+#include "kc/NativeCalibrator.hpp"
+#include "kc/io.hpp"
+
+#include "synthetic.hpp"
+
+#include "catch2/catch.hpp"
+
+// kc::NativeCalibrator on noise-free synthetic KUKA samples: convergence to the generating
+// parameters, bounds, constant parameters and independence of the thread count
+namespace
+{
+  using KUKA = synthetic::KUKA;
+
+  constexpr std::size_t N        = synthetic::N;
+  constexpr std::size_t samples  = 1000;
+  constexpr std::size_t training = 800;
+
+  struct Fixture
+  {
+    kc::Columns<N>        joint_angles;
+    kc::Columns<3>        xyz;
+    synthetic::Parameters truth;
+
+    Fixture()
+    {
+      synthetic::joint_angles(samples, joint_angles);
+      truth = synthetic::Parameters{synthetic::nominal_identifiability(joint_angles, {{0, training}}), 5};
+    }
+  };
+
+  // Tolerances that let the noise-free fits run to the rounding level
+  auto tight() -> kc::NativeOptions
+  {
+    kc::NativeOptions out;
+    out.num_threads         = 1;
+    out.function_tolerance  = 1e-15;
+    out.parameter_tolerance = 1e-15;
+    return out;
+  }
+
+  auto solve(const Fixture &fixture, synthetic::Parameters &p, const kc::NativeOptions &options) -> kc::NativeSummary
+  {
+    kc::NativeCalibrator<KUKA> calibrator(fixture.joint_angles, fixture.xyz, p.a, p.alpha, p.d, p.theta, options);
+    return calibrator.solve();
+  }
+} // namespace
+
+TEST_CASE("NativeCalibrator converges to the generating parameters", "[native]")
+{
+  Fixture fixture;
+  synthetic::positions(fixture.truth, fixture.joint_angles, fixture.xyz);
+
+  synthetic::Parameters   p;
+  const kc::NativeSummary summary = solve(fixture, p, tight());
+  REQUIRE(summary.converged);
+  REQUIRE(summary.final_cost < 1e-20);
+  REQUIRE(p.distance(fixture.truth) < 1e-9);
+}
+
+TEST_CASE("NativeCalibrator gives bitwise identical results for any thread count", "[native]")
+{
+  Fixture fixture;
+  synthetic::positions(fixture.truth, fixture.joint_angles, fixture.xyz, 1e-4);
+
+  kc::NativeOptions options;
+  options.num_threads = 1;
+  synthetic::Parameters   serial;
+  const kc::NativeSummary reference = solve(fixture, serial, options);
+
+  for (const std::size_t threads : {2, 3, 8})
+  {
+    options.num_threads = threads;
+    synthetic::Parameters   parallel;
+    const kc::NativeSummary summary = solve(fixture, parallel, options);
+    INFO(threads << " threads");
+    REQUIRE(summary.iterations == reference.iterations);
+    REQUIRE(summary.final_cost == reference.final_cost);
+    REQUIRE(std::memcmp(&parallel, &serial, sizeof(serial)) == 0);
+  }
+}
+
+TEST_CASE("NativeCalibrator keeps the parameters inside the bounds", "[native]")
+{
+  // The generating a of link 1 is negative, out of the box of a bounded solve
+  Fixture fixture;
+  fixture.truth.a[1] = -2e-3;
+  synthetic::positions(fixture.truth, fixture.joint_angles, fixture.xyz);
+
+  kc::NativeOptions options = tight();
+
+  synthetic::Parameters bounded;
+  solve(fixture, bounded, options);
+  REQUIRE(bounded.a[1] == 0.);
+  for (std::size_t i{}; i < N; ++i)
+  {
+    REQUIRE(bounded.a[i] >= 0.);
+    REQUIRE(bounded.d[i] >= 0.);
+    REQUIRE(bounded.alpha[i] >= 0.);
+    REQUIRE(bounded.alpha[i] <= 2. * M_PI);
+    REQUIRE(bounded.theta[i] >= 0.);
+    REQUIRE(bounded.theta[i] <= 2. * M_PI);
+  }
+
+  options.bounded = false;
+  synthetic::Parameters unbounded;
+  solve(fixture, unbounded, options);
+  REQUIRE(unbounded.distance(fixture.truth) < 1e-9);
+}
+
+TEST_CASE("NativeCalibrator holds the constant parameters", "[native]")
+{
+  Fixture fixture;
+
+  SECTION("at a value outside the bounds")
+  {
+    // theta of link 2 is negative, held at its generating value: the others still fit exactly.
+    // The held values are set after construction, which analyses identifiability at the nominal
+    // parameters, as synthetic::Parameters does.
+    fixture.truth.theta[2] = -0.1;
+    synthetic::positions(fixture.truth, fixture.joint_angles, fixture.xyz);
+
+    synthetic::Parameters      p;
+    kc::NativeCalibrator<KUKA> calibrator(fixture.joint_angles, fixture.xyz, p.a, p.alpha, p.d, p.theta, tight());
+    p.theta[2] = -0.1;
+    calibrator.set_constant(3, 2);
+    const kc::NativeSummary summary = calibrator.solve();
+    REQUIRE(p.theta[2] == -0.1);
+    REQUIRE(summary.converged);
+    REQUIRE(p.distance(fixture.truth) < 1e-9);
+  }
+  SECTION("away from the optimum")
+  {
+    synthetic::positions(fixture.truth, fixture.joint_angles, fixture.xyz);
+
+    synthetic::Parameters      p;
+    kc::NativeCalibrator<KUKA> calibrator(fixture.joint_angles, fixture.xyz, p.a, p.alpha, p.d, p.theta, tight());
+    p.d[2] = fixture.truth.d[2] + 1e-3;
+    calibrator.set_constant(2, 2);
+    const kc::NativeSummary summary = calibrator.solve();
+    REQUIRE(p.d[2] == fixture.truth.d[2] + 1e-3);
+    REQUIRE(summary.final_cost < summary.initial_cost);
+  }
+  SECTION("whole blocks")
+  {
+    synthetic::positions(fixture.truth, fixture.joint_angles, fixture.xyz);
+
+    synthetic::Parameters      p;
+    kc::NativeCalibrator<KUKA> calibrator(fixture.joint_angles, fixture.xyz, p.a, p.alpha, p.d, p.theta, tight());
+    p.a[4] = 0.01;
+    calibrator.set_constant(0);
+    calibrator.solve();
+    const synthetic::Parameters nominal;
+    for (std::size_t i{}; i < N; ++i)
+      REQUIRE(p.a[i] == (i == 4 ? 0.01 : nominal.a[i]));
+  }
+}
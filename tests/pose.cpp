@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "kc/PoseCostFunction.hpp"
+#include "kc/Robot.hpp"
+#include "kc/robots.hpp"
+
+#include "catch2/catch.hpp"
+
+// The analytic 6-row Jacobian of kc::PoseCostFunction and so3::left_jacobian_inverse against
+// central differences, including the small-angle series and residual rotations close to pi
+namespace
+{
+  auto exp(const Eigen::Vector3d &phi) -> Eigen::Matrix3d
+  {
+    const double angle = phi.norm();
+    return angle == 0. ? Eigen::Matrix3d::Identity() : Eigen::AngleAxisd{angle, phi / angle}.toRotationMatrix();
+  }
+
+  // J_l^-1(phi) by central differences of its definition, log(exp([omega]x) exp([phi]x))
+  auto numeric_left_jacobian_inverse(const Eigen::Vector3d &phi, const double step = 1e-7) -> Eigen::Matrix3d
+  {
+    const Eigen::Matrix3d R = exp(phi);
+    Eigen::Matrix3d       out;
+    for (Eigen::Index k{}; k < 3; ++k)
+    {
+      const Eigen::Vector3d omega = step * Eigen::Vector3d::Unit(k);
+      out.col(k)                  = (kc::so3::log(exp(omega) * R) - kc::so3::log(exp(-omega) * R)) / (2. * step);
+    }
+    return out;
+  }
+
+  // The closed form of J_l^-1(phi) in long double, accurate to about 1e-19 / |phi|^2
+  auto reference_left_jacobian_inverse(const Eigen::Vector3d &phi) -> Eigen::Matrix3d
+  {
+    using Matrix = Eigen::Matrix<long double, 3, 3>;
+
+    const Eigen::Vector3<long double> p     = phi.cast<long double>();
+    const long double                 angle = p.norm();
+    const Matrix                      hat{{0., -p.z(), p.y()}, {p.z(), 0., -p.x()}, {-p.y(), p.x(), 0.}};
+    const long double                 c = (1.L - angle * std::sin(angle) / (2.L * (1.L - std::cos(angle)))) / (angle * angle);
+    return (Matrix::Identity() - 0.5L * hat + c * hat * hat).cast<double>();
+  }
+
+  template<class Robot>
+  struct Sample
+  {
+    static constexpr std::size_t N = Robot::N;
+
+    double                      a[N], alpha[N], d[N], theta[N];
+    const double               *blocks[4]{a, alpha, d, theta};
+    typename Robot::JointAngles q;
+
+    explicit Sample(std::mt19937 &generator)
+    {
+      std::uniform_real_distribution<double> length{0., 0.5}, angle{0., 2. * M_PI}, joint{-M_PI, M_PI};
+      for (std::size_t link{}; link < N; ++link)
+      {
+        a[link]     = length(generator);
+        alpha[link] = angle(generator);
+        d[link]     = length(generator);
+        theta[link] = angle(generator);
+        q[link]     = joint(generator);
+      }
+    }
+
+    // The measured orientation: the one of the chain rotated by exp([residual]x), so that the
+    // rotation residual log(R R_measured^T) is -residual
+    [[nodiscard]] auto orientation(const Eigen::Vector3d &residual) const -> Eigen::Quaterniond
+    {
+      const kc::TransformationMatrix pose = Robot::fk_pose(a, alpha, d, theta, q);
+      return Eigen::Quaterniond{Eigen::Matrix3d{exp(residual) * pose.template topLeftCorner<3, 3>()}};
+    }
+  };
+
+  // Largest difference between the analytic Jacobian blocks of cost and central differences of
+  // its residuals
+  template<class Robot>
+  auto jacobian_error(const kc::PoseCostFunction<Robot> &cost, Sample<Robot> s, const double step = 1e-6) -> double
+  {
+    constexpr std::size_t N = Robot::N;
+
+    std::vector<double> jacobian(4 * 6 * N);
+    double             *jacobians[4] = {&jacobian[0], &jacobian[6 * N], &jacobian[12 * N], &jacobian[18 * N]};
+    double              residuals[6], forward[6], backward[6];
+    REQUIRE(cost.Evaluate(s.blocks, residuals, jacobians));
+
+    double out{};
+    for (std::size_t block{}; block < 4; ++block)
+      for (std::size_t link{}; link < N; ++link)
+      {
+        double      *parameter = const_cast<double *>(s.blocks[block]) + link;
+        const double value     = *parameter;
+        *parameter             = value + step;
+        cost.Evaluate(s.blocks, forward, nullptr);
+        *parameter = value - step;
+        cost.Evaluate(s.blocks, backward, nullptr);
+        *parameter = value;
+        for (std::size_t row{}; row < 6; ++row)
+          out = std::max(out, std::abs(jacobians[block][row * N + link] - (forward[row] - backward[row]) / (2. * step)));
+      }
+    return out;
+  }
+} // namespace
+
+TEST_CASE("left_jacobian_inverse matches central differences of so3::log", "[pose]")
+{
+  std::mt19937                           generator{31};
+  std::normal_distribution<double>       direction{0., 1.};
+  std::uniform_real_distribution<double> angle{0., 3.};
+  const auto                             axis = [&] { return Eigen::Vector3d{direction(generator), direction(generator), direction(generator)}.normalized(); };
+
+  SECTION("generic angles")
+  {
+    for (int i{}; i < 100; ++i)
+    {
+      const Eigen::Vector3d phi = angle(generator) * axis();
+      REQUIRE((kc::so3::left_jacobian_inverse(phi) - numeric_left_jacobian_inverse(phi)).cwiseAbs().maxCoeff() < 1e-7);
+    }
+  }
+  SECTION("series below 0.1 rad")
+  {
+    for (const double small : {0., 1e-9, 1e-6, 1e-4, 1e-2, 0.099})
+    {
+      const Eigen::Vector3d phi = small * axis();
+      REQUIRE((kc::so3::left_jacobian_inverse(phi) - numeric_left_jacobian_inverse(phi)).cwiseAbs().maxCoeff() < 1e-7);
+    }
+    // On both sides of the switch to the closed form, as accurate as the closed form in long double
+    const Eigen::Vector3d u = axis();
+    for (const double around : {1e-2, 0.0999999, 0.1000001, 0.3})
+      REQUIRE((kc::so3::left_jacobian_inverse(around * u) - reference_left_jacobian_inverse(around * u)).cwiseAbs().maxCoeff() < 1e-13);
+  }
+  SECTION("close to pi")
+  {
+    for (const double gap : {1e-1, 1e-2, 1e-3})
+    {
+      const Eigen::Vector3d phi = (M_PI - gap) * axis();
+      REQUIRE(kc::so3::log(exp(phi)).isApprox(phi, 1e-12));
+      REQUIRE((kc::so3::left_jacobian_inverse(phi) - numeric_left_jacobian_inverse(phi)).cwiseAbs().maxCoeff() < 1e-5);
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("PoseCostFunction Jacobian matches central differences", "[pose]",
+                   kc::robots::ThreeR, kc::robots::Stanford, kc::robots::KUKA)
+{
+  constexpr double weight = 2.5, orientation_scale = 0.3;
+
+  std::mt19937                           generator{32};
+  std::normal_distribution<double>       direction{0., 1.};
+  std::uniform_real_distribution<double> angle{0., 2.};
+  const auto                             axis = [&] { return Eigen::Vector3d{direction(generator), direction(generator), direction(generator)}.normalized(); };
+  const kc::PositionVector               y{0.1, -0.2, 0.3};
+
+  SECTION("generic residual rotations")
+  {
+    for (int i{}; i < 50; ++i)
+    {
+      const Sample<TestType>               s{generator};
+      const kc::PoseCostFunction<TestType> cost{s.q, y, s.orientation(angle(generator) * axis()), orientation_scale, weight};
+      REQUIRE(jacobian_error(cost, s) < 1e-8);
+    }
+  }
+  SECTION("zero residual rotation (small-angle series)")
+  {
+    for (int i{}; i < 20; ++i)
+    {
+      const Sample<TestType>               s{generator};
+      const kc::PoseCostFunction<TestType> cost{s.q, y, s.orientation(Eigen::Vector3d::Zero()), orientation_scale, weight};
+      REQUIRE(jacobian_error(cost, s) < 1e-8);
+    }
+  }
+  SECTION("residual rotation close to pi")
+  {
+    for (int i{}; i < 20; ++i)
+    {
+      const Sample<TestType>               s{generator};
+      const kc::PoseCostFunction<TestType> cost{s.q, y, s.orientation((M_PI - 1e-2) * axis()), orientation_scale, weight};
+      REQUIRE(jacobian_error(cost, s) < 1e-6);
+    }
+  }
+}
+
+TEST_CASE("PoseCostFunction residuals scale with the weight and the orientation scale", "[pose]")
+{
+  using Stanford = kc::robots::Stanford;
+
+  std::mt19937                         generator{33};
+  const Sample<Stanford>               s{generator};
+  const Eigen::Vector3d                rotation{0.1, -0.2, 0.05};
+  const kc::PositionVector             y{0.1, -0.2, 0.3};
+  const kc::PoseCostFunction<Stanford> cost{s.q, y, s.orientation(rotation), 0.3, 4.};
+  double                               residuals[6];
+  REQUIRE(cost.Evaluate(s.blocks, residuals, nullptr));
+
+  const kc::PositionVector position = Stanford::fk(s.a, s.alpha, s.d, s.theta, s.q);
+  for (Eigen::Index row{}; row < 3; ++row)
+  {
+    REQUIRE(residuals[row] == Approx(2. * (position[row] - y[row])).epsilon(1e-12));
+    REQUIRE(residuals[row + 3] == Approx(-2. * 0.3 * rotation[row]).epsilon(1e-9));
+  }
+}
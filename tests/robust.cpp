@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "kc/Calibrator.hpp"
+#include "kc/io.hpp"
+#include "kc/robust.hpp"
+
+#include "synthetic.hpp"
+
+#include "catch2/catch.hpp"
+
+// kc::screen, kc::robust_weights and kc::robust_calibrate on synthetic KUKA samples with gross
+// outliers injected at known rows of the training split
+namespace
+{
+  using KUKA = synthetic::KUKA;
+
+  constexpr std::size_t N        = synthetic::N;
+  constexpr std::size_t samples  = 2000;
+  constexpr std::size_t training = 1600; // CalibrationOptions::training_fraction of 0.8
+
+  struct Fixture
+  {
+    kc::Columns<N>               joint_angles;
+    kc::Columns<3>               xyz;
+    synthetic::Parameters        truth;
+    std::vector<std::size_t>     corrupted; // training rows off by 5 to 10 cm
+    std::vector<kc::SampleRange> inliers;   // the other training rows
+
+    Fixture()
+    {
+      for (std::size_t i{13}; i < training; i += 47)
+      {
+        inliers.emplace_back(corrupted.empty() ? 0 : corrupted.back() + 1, i);
+        corrupted.push_back(i);
+      }
+      inliers.emplace_back(corrupted.back() + 1, training);
+
+      synthetic::joint_angles(samples, joint_angles);
+      truth = synthetic::Parameters{synthetic::nominal_identifiability(joint_angles, inliers), 7};
+      synthetic::positions(truth, joint_angles, xyz, 1e-5);
+
+      std::mt19937                           generator{3};
+      std::uniform_real_distribution<double> offset{0.05, 0.1};
+      std::normal_distribution<double>       direction{0., 1.};
+      for (const std::size_t i : corrupted)
+      {
+        Eigen::Vector3d u{direction(generator), direction(generator), direction(generator)};
+        u = u.normalized() * offset(generator);
+        for (std::size_t axis{}; axis < 3; ++axis)
+          xyz.data()[axis * samples + i] += u[Eigen::Index(axis)];
+      }
+    }
+  };
+} // namespace
+
+TEST_CASE("screen drops exactly the gross outliers", "[robust]")
+{
+  const Fixture               fixture;
+  const synthetic::Parameters nominal;
+
+  const kc::Screening screening = kc::screen<KUKA>(nominal.a, nominal.alpha, nominal.d, nominal.theta,
+                                                   fixture.joint_angles, fixture.xyz, 0, training);
+  REQUIRE(screening.samples == training);
+  REQUIRE(screening.rejected == fixture.corrupted.size());
+  REQUIRE(screening.inliers == fixture.inliers);
+}
+
+TEST_CASE("robust_weights match the closed forms of the losses", "[robust]")
+{
+  // Samples [0, 100) at errors 0.001 * (i + 1) from the generating parameters, along x
+  const Fixture  fixture;
+  kc::Columns<3> xyz;
+  synthetic::positions(fixture.truth, fixture.joint_angles, xyz);
+  for (std::size_t i{}; i < 100; ++i)
+    xyz.data()[i] += 1e-3 * double(i + 1);
+  const std::vector<kc::SampleRange> ranges = {{0, 45}, {55, 100}};
+
+  kc::RobustOptions options;
+  options.loss_scale = 0.02;
+
+  std::vector<double> weights;
+  SECTION("Huber")
+  {
+    options.loss = kc::Loss::Huber;
+    REQUIRE(kc::robust_weights<KUKA>(fixture.truth.a, fixture.truth.alpha, fixture.truth.d, fixture.truth.theta,
+                                     fixture.joint_angles, xyz, ranges, options, weights) == 0.02);
+    for (std::size_t i{}; i < 100; ++i)
+    {
+      const double error = 1e-3 * double(i + 1);
+      if (i >= 45 && i < 55)
+        REQUIRE(weights[i] == 0.);
+      else
+        REQUIRE(weights[i] == Approx(error <= 0.02 ? 1. : 0.02 / error).epsilon(1e-9));
+    }
+  }
+  SECTION("Cauchy")
+  {
+    options.loss = kc::Loss::Cauchy;
+    REQUIRE(kc::robust_weights<KUKA>(fixture.truth.a, fixture.truth.alpha, fixture.truth.d, fixture.truth.theta,
+                                     fixture.joint_angles, xyz, ranges, options, weights) == 0.02);
+    for (std::size_t i{}; i < 100; ++i)
+    {
+      const double error = 1e-3 * double(i + 1);
+      if (i >= 45 && i < 55)
+        REQUIRE(weights[i] == 0.);
+      else
+        REQUIRE(weights[i] == Approx(1. / (1. + (error / 0.02) * (error / 0.02))).epsilon(1e-9));
+    }
+  }
+  SECTION("scale from the median and MAD of the errors")
+  {
+    options.loss       = kc::Loss::Huber;
+    options.loss_scale = 0.;
+    // errors 1 to 45 and 56 to 100 mm: nearest-rank median 45 mm, MAD 27 mm
+    const double scale = kc::robust_weights<KUKA>(fixture.truth.a, fixture.truth.alpha, fixture.truth.d, fixture.truth.theta,
+                                                  fixture.joint_angles, xyz, ranges, options, weights);
+    REQUIRE(scale == Approx(0.045 + 1.345 * 1.4826 * 0.027).epsilon(1e-6));
+  }
+  REQUIRE(weights.size() == samples);
+  REQUIRE(std::all_of(weights.begin() + 100, weights.end(), [](const double weight) { return weight == 0.; }));
+}
+
+TEST_CASE("robust_calibrate recovers the parameters that outliers bias", "[robust]")
+{
+  const Fixture          fixture;
+  kc::CalibrationOptions calibration;
+  calibration.num_threads        = 1;
+  calibration.max_num_iterations = 100;
+
+  synthetic::Parameters plain;
+  {
+    kc::Calibrator<KUKA> calibrator(fixture.joint_angles, fixture.xyz, plain.a, plain.alpha, plain.d, plain.theta, calibration);
+    calibrator.solve();
+  }
+  REQUIRE(plain.distance(fixture.truth) > 1e-3);
+
+  for (const kc::Loss loss : {kc::Loss::Trivial, kc::Loss::Huber, kc::Loss::Cauchy})
+  {
+    kc::RobustOptions options;
+    options.num_threads = 1;
+    options.loss        = loss;
+
+    synthetic::Parameters       robust;
+    const kc::RobustCalibration result = kc::robust_calibrate<KUKA>(fixture.joint_angles, fixture.xyz, robust.a, robust.alpha,
+                                                                     robust.d, robust.theta, calibration, options);
+    REQUIRE(result.training == training);
+    REQUIRE(result.screening.rejected == fixture.corrupted.size());
+    REQUIRE(result.summaries.size() >= 1);
+    REQUIRE(result.summaries.size() <= 1 + (loss == kc::Loss::Trivial ? 0 : options.reweighting_iterations));
+    REQUIRE(robust.distance(fixture.truth) < 1e-5);
+  }
+}
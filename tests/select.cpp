@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "kc/io.hpp"
+#include "kc/select.hpp"
+
+#include "synthetic.hpp"
+
+#include "catch2/catch.hpp"
+
+// kc::select_samples on random KUKA poses: the log det tracked through the Woodbury updates
+// against the one of the selected samples recomputed from scratch, and reproducibility
+namespace
+{
+  using KUKA = synthetic::KUKA;
+
+  constexpr std::size_t N       = synthetic::N;
+  constexpr std::size_t P       = 4 * N;
+  constexpr std::size_t samples = 3000;
+  constexpr std::size_t begin   = 500;
+  constexpr std::size_t K       = 60;
+
+  using Information = Eigen::Matrix<double, P, P>;
+
+  // sum of J^T J over rows, plus epsilon I
+  auto information(const synthetic::Parameters &p, const kc::Columns<N> &joint_angles, const std::vector<std::size_t> &rows,
+                   const double epsilon) -> Information
+  {
+    Information out = epsilon * Information::Identity();
+    for (const std::size_t i : rows)
+    {
+      const KUKA::JacobianMatrix J = KUKA::jacobian(p.a, p.alpha, p.d, p.theta, joint_angles.row(i));
+      out.noalias() += J.transpose() * J;
+    }
+    return out;
+  }
+
+  auto log_det(const Information &M) -> double { return 2. * M.llt().matrixLLT().diagonal().array().log().sum(); }
+} // namespace
+
+TEST_CASE("select_samples tracks the log det of the selected samples", "[select]")
+{
+  const synthetic::Parameters p;
+  kc::Columns<N>              joint_angles;
+  synthetic::joint_angles(samples, joint_angles);
+
+  const kc::SelectionOptions options;
+  const kc::Selection        selection = kc::select_samples<KUKA>(p.a, p.alpha, p.d, p.theta, joint_angles, begin, samples, K, options);
+  REQUIRE(selection.samples.size() == K);
+  REQUIRE(std::is_sorted(selection.samples.begin(), selection.samples.end()));
+  REQUIRE(std::adjacent_find(selection.samples.begin(), selection.samples.end()) == selection.samples.end());
+  REQUIRE(selection.samples.front() >= begin);
+  REQUIRE(selection.samples.back() < samples);
+
+  std::vector<std::size_t> all(samples - begin);
+  std::iota(all.begin(), all.end(), begin);
+  const Information full    = information(p, joint_angles, all, 0.);
+  const double      epsilon = options.ridge * full.trace() / double(P);
+  REQUIRE(selection.full_log_det == Approx(log_det(full + epsilon * Information::Identity())).epsilon(1e-10));
+  REQUIRE(selection.log_det == Approx(log_det(information(p, joint_angles, selection.samples, epsilon))).epsilon(1e-9));
+  REQUIRE(selection.efficiency > 0.);
+}
+
+TEST_CASE("select_samples is deterministic for a fixed seed", "[select]")
+{
+  const synthetic::Parameters p;
+  kc::Columns<N>              joint_angles;
+  synthetic::joint_angles(samples, joint_angles);
+
+  kc::SelectionOptions options;
+  options.num_threads           = 1;
+  const kc::Selection reference = kc::select_samples<KUKA>(p.a, p.alpha, p.d, p.theta, joint_angles, begin, samples, K, options);
+
+  for (const std::size_t threads : {1, 4})
+  {
+    options.num_threads           = threads;
+    const kc::Selection selection = kc::select_samples<KUKA>(p.a, p.alpha, p.d, p.theta, joint_angles, begin, samples, K, options);
+    INFO(threads << " threads");
+    REQUIRE(selection.samples == reference.samples);
+    REQUIRE(selection.log_det == reference.log_det);
+    REQUIRE(selection.full_log_det == reference.full_log_det);
+    REQUIRE(selection.evaluations == reference.evaluations);
+  }
+
+  options.seed                 = 2;
+  const kc::Selection reseeded = kc::select_samples<KUKA>(p.a, p.alpha, p.d, p.theta, joint_angles, begin, samples, K, options);
+  REQUIRE(reseeded.samples != reference.samples);
+}
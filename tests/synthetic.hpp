@@ -0,0 +1,94 @@
+#ifndef KC_TESTS_SYNTHETIC_HPP_
+#define KC_TESTS_SYNTHETIC_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "kc/identifiability.hpp"
+#include "kc/io.hpp"
+#include "kc/robots.hpp"
+
+// Synthetic KUKA measurements for the tests, generated by known DH parameters (see also
+// benchmarks/synthetic.hpp).
+namespace synthetic
+{
+  using KUKA = kc::robots::KUKA;
+
+  constexpr std::size_t N = KUKA::N;
+
+  // The nominal DH parameters, or the generating ones once offset
+  struct Parameters
+  {
+    // clang-format off
+    double a[N]     = {      0,      0,      0,      0,      0,      0,     0 };
+    double alpha[N] = { M_PI_2, M_PI_2, M_PI_2, M_PI_2, M_PI_2, M_PI_2,     0 };
+    double d[N]     = {   0.34,      0,    0.4,      0,    0.4,      0, 0.126 };
+    double theta[N] = {   M_PI,   M_PI,      0,   M_PI,      0,   M_PI,     0 };
+    // clang-format on
+
+    Parameters() = default;
+
+    // The nominal parameters offset by up to a millimetre or a milliradian, except the ones
+    // identifiability holds fixed: the generating parameters are then the only optimum of a fit
+    // that starts from the nominal ones.
+    Parameters(const kc::Identifiability &identifiability, const unsigned seed)
+    {
+      std::mt19937                           generator{seed};
+      std::uniform_real_distribution<double> offset{0., 1e-3};
+      const std::array<double *, 4>          blocks = {a, alpha, d, theta};
+      for (std::size_t block{}; block < 4; ++block)
+        for (std::size_t i{}; i < N; ++i)
+        {
+          const double value = offset(generator);
+          const auto  &fixed = identifiability.fixed[block];
+          if (std::find(fixed.begin(), fixed.end(), int(i)) == fixed.end()) blocks[block][i] += value;
+        }
+    }
+
+    // Largest absolute difference to other over all parameters
+    [[nodiscard]] auto distance(const Parameters &other) const -> double
+    {
+      double out{};
+      for (std::size_t i{}; i < N; ++i)
+        out = std::max({out, std::abs(a[i] - other.a[i]), std::abs(alpha[i] - other.alpha[i]),
+                        std::abs(d[i] - other.d[i]), std::abs(theta[i] - other.theta[i])});
+      return out;
+    }
+  };
+
+  // samples random joint configurations
+  inline void joint_angles(const std::size_t samples, kc::Columns<N> &out, const unsigned seed = 42)
+  {
+    std::mt19937                           generator{seed};
+    std::uniform_real_distribution<double> angle{-M_PI, M_PI};
+    out.resize(samples);
+    std::generate_n(out.data(), N * samples, [&] { return angle(generator); });
+  }
+
+  // The end-effector positions of joint_angles under truth, with Gaussian tracker noise of
+  // standard deviation noise.
+  inline void positions(const Parameters &truth, const kc::Columns<N> &joint_angles, kc::Columns<3> &xyz,
+                        const double noise = 0., const unsigned seed = 43)
+  {
+    xyz.resize(joint_angles.rows());
+    KUKA::fk_batch(truth.a, truth.alpha, truth.d, truth.theta, joint_angles.data(), joint_angles.rows(), xyz.data());
+    if (noise == 0.) return;
+    std::mt19937                     generator{seed};
+    std::normal_distribution<double> tracker{0., noise};
+    std::for_each(xyz.data(), xyz.data() + 3 * xyz.rows(), [&](double &value) { value += tracker(generator); });
+  }
+
+  // Identifiability of the KUKA parameters at the nominal ones from the samples in ranges, which
+  // must be the training samples of the fit: the fixed parameters differ between close sets of
+  // poses when several columns are nearly dependent.
+  inline auto nominal_identifiability(const kc::Columns<N> &joint_angles, const std::vector<kc::SampleRange> &ranges) -> kc::Identifiability
+  {
+    const Parameters nominal;
+    return kc::identifiability<KUKA>(nominal.a, nominal.alpha, nominal.d, nominal.theta, joint_angles, ranges);
+  }
+} // namespace synthetic
+
+#endif // KC_TESTS_SYNTHETIC_HPP_
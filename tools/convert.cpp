@@ -0,0 +1,38 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "kc/Dataset.hpp"
+#include "kc/io.hpp"
+
+constexpr std::size_t max_joints = 12;
+
+// Converts a joint angle / position text pair into a binary kc dataset, e.g.
+//   ./tools/convert 6 data/Q_Stanford.txt data/P_Stanford.txt Stanford.kcd
+template<std::size_t... Ns>
+auto convert(const std::size_t joints, const char *const q, const char *const xyz, const char *const out, std::index_sequence<Ns...>) -> kc::LoadStatus
+{
+  kc::LoadStatus status{kc::LoadError::Format, 0, "Unsupported number of joints " + std::to_string(joints)};
+  ((joints == Ns + 1 ? (status = kc::convert_dataset<Ns + 1>(q, xyz, out), true) : false) || ...);
+  return status;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc != 5)
+  {
+    std::cerr << "usage: " << argv[0] << " <joints> <Q.txt> <P.txt> <out.kcd>\n";
+    return EXIT_FAILURE;
+  }
+
+  const std::size_t joints = std::strtoul(argv[1], nullptr, 10);
+  if (const auto status = convert(joints, argv[2], argv[3], argv[4], std::make_index_sequence<max_joints>{}); !status)
+  {
+    std::cerr << status.message << "\n";
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Wrote " << argv[4] << "\n";
+  return 0;
+}
@@ -0,0 +1,39 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "kc/Fleet.hpp"
+
+// Calibrates every arm of a fleet manifest concurrently and streams the results as JSON lines, e.g.
+//   ./tools/fleet data/fleet.manifest results.jsonl [threads]
+int main(int argc, char **argv)
+{
+  if (argc != 3 && argc != 4)
+  {
+    std::cerr << "usage: " << argv[0] << " <manifest> <results.jsonl> [threads]\n";
+    return EXIT_FAILURE;
+  }
+
+  std::vector<kc::FleetJob> jobs;
+  if (const auto status = kc::load_manifest(argv[1], jobs); !status)
+  {
+    std::cerr << status.message << "\n";
+    return EXIT_FAILURE;
+  }
+
+  std::ofstream out(argv[2]);
+  if (!out)
+  {
+    std::cerr << "Could not open file " << argv[2] << " for writing\n";
+    return EXIT_FAILURE;
+  }
+
+  kc::FleetOptions options;
+  if (argc == 4) options.num_threads = std::strtoul(argv[3], nullptr, 10);
+
+  const kc::FleetSummary summary = kc::run_fleet(jobs, options, out);
+  std::cout << summary.jobs << " jobs, " << summary.failed << " failed in " << summary.seconds << " s, results in " << argv[2] << "\n";
+  return summary.failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}